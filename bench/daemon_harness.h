@@ -0,0 +1,88 @@
+#pragma once
+
+// Helpers for the benchmarks that drive a real daemon over its socket: the
+// daemon runs in a forked child so its loops and the benchmark's clients do
+// not share threads, as they would not in real use.
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "clock.h"
+#include "daemon.h"
+#include "ipc.h"
+#include "shutdown.h"
+
+// Descriptors besides the clients: the daemon's own, stdio, epoll
+inline constexpr rlim_t kSpareDescriptors = 64;
+
+// Lets this process and the daemon it forks hold clients connections
+inline bool raise_descriptor_limit(std::size_t clients) {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return false;
+  }
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  return limit.rlim_cur >= static_cast<rlim_t>(clients) + kSpareDescriptors;
+}
+
+inline std::string bench_socket_path() {
+  return "/tmp/pomodoro-bench-" + std::to_string(getpid()) + ".sock";
+}
+
+// Forks a daemon with shards event loops listening on path, with no
+// checkpoint or status file
+inline pid_t start_daemon(const std::string& path, std::size_t shards) {
+  std::signal(SIGPIPE, SIG_IGN);
+  const pid_t child = fork();
+  if (child == 0) {
+    using namespace std::chrono_literals;
+    shutdown_install();
+    SteadyClock clock;
+    const DaemonConfig config{path, "", "", {25min}, {5min}, shards};
+    _exit(daemon_run(config, clock));
+  }
+  return child;
+}
+
+inline void stop_daemon(pid_t daemon) {
+  kill(daemon, SIGTERM);
+  waitpid(daemon, nullptr, 0);
+}
+
+// The first connection, retried while the daemon starts up
+inline int connect_when_ready(const std::string& path) {
+  using namespace std::chrono_literals;
+  constexpr auto kStartupTimeout = 5s;
+  const auto give_up = std::chrono::steady_clock::now() + kStartupTimeout;
+  int fd = ipc_connect(path);
+  while (fd < 0 && std::chrono::steady_clock::now() < give_up) {
+    std::this_thread::sleep_for(10ms);
+    fd = ipc_connect(path);
+  }
+  return fd;
+}
+
+inline bool send_attach(int fd, std::string_view timer) {
+  std::array<std::uint8_t, kMaxMessageLength> message{};
+  const std::size_t length = ipc_encode_attach(timer, message);
+  return length != 0 &&
+         ipc_send(fd, std::span<const std::uint8_t>(message.data(), length));
+}
+
+inline bool send_command(int fd, MessageType command) {
+  std::array<std::uint8_t, kMaxMessageLength> message{};
+  const std::size_t length = ipc_encode_command(command, message);
+  return ipc_send(fd, std::span<const std::uint8_t>(message.data(), length));
+}
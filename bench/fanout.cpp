@@ -0,0 +1,159 @@
+// Measures how fast one state change reaches every attached client: forks a
+// daemon, attaches CLIENTS connections to its own timer, then toggles the
+// timer ROUNDS times from the first client and times, for every client, the
+// gap between sending the command and receiving the resulting event.
+// Latencies are end to end (daemon wakeup, encode, fan-out, socket, and this
+// process reading 10,000 sockets in turn), so the tail is what a user on the
+// slowest connection would see. The clients wait on epoll, so the benchmark
+// needs Linux.
+//
+//   bench_fanout [CLIENTS] [ROUNDS] [SHARDS]
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "daemon_harness.h"
+#include "ipc.h"
+
+using namespace std::chrono;
+
+namespace {
+constexpr int kDefaultClients = 10000;
+constexpr int kDefaultRounds = 50;
+constexpr std::size_t kDefaultShards = 1;
+constexpr int kMaxEvents = 256;
+constexpr int kEventTimeoutMs = 10000;
+
+struct Clients {
+  std::vector<int> fds;
+  std::vector<FrameBuffer> input;
+  // Round each client last received an event in
+  std::vector<int> seen;
+  int epoll_fd = -1;
+};
+
+// Waits until every client has received an event for round, recording each
+// arrival relative to sent; false on timeout or a lost connection
+bool collect(Clients& clients, int round, steady_clock::time_point sent,
+             std::vector<steady_clock::duration>& latencies) {
+  std::array<epoll_event, kMaxEvents> ready{};
+  std::size_t waiting = clients.fds.size();
+  while (waiting > 0) {
+    const int count =
+        epoll_wait(clients.epoll_fd, ready.data(), kMaxEvents,
+                   kEventTimeoutMs);
+    if (count <= 0) {
+      return false;
+    }
+    const auto arrived = steady_clock::now();
+    for (const epoll_event& event : std::span(ready.data(), count)) {
+      const auto index = static_cast<std::size_t>(event.data.u64);
+      FrameBuffer& input = clients.input[index];
+      if (input.fill(clients.fds[index]) == ReadResult::kClosed) {
+        return false;
+      }
+      Frame frame{};
+      while (input.next(frame)) {
+        if (frame.type == MessageType::kState &&
+            clients.seen[index] < round) {
+          clients.seen[index] = round;
+          latencies.push_back(arrived - sent);
+          --waiting;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+double micros(steady_clock::duration value) {
+  return duration<double, std::micro>(value).count();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const int client_count = argc > 1 ? std::atoi(argv[1]) : kDefaultClients;
+  const int rounds = argc > 2 ? std::atoi(argv[2]) : kDefaultRounds;
+  const std::size_t shards =
+      argc > 3 ? std::strtoul(argv[3], nullptr, 10) : kDefaultShards;
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  if (client_count < 1 || rounds < 1 || shards < 1) {
+    std::fprintf(stderr, "usage: bench_fanout [CLIENTS] [ROUNDS] [SHARDS]\n");
+    return 1;
+  }
+  if (!raise_descriptor_limit(static_cast<std::size_t>(client_count))) {
+    std::fprintf(stderr, "bench_fanout: descriptor limit below %d clients\n",
+                 client_count);
+    return 1;
+  }
+  const std::string path = bench_socket_path();
+  const pid_t daemon = start_daemon(path, shards);
+
+  Clients clients;
+  clients.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  clients.fds.reserve(client_count);
+  clients.input.resize(client_count);
+  clients.seen.assign(client_count, -1);
+  bool ok = clients.epoll_fd >= 0;
+  for (int index = 0; ok && index < client_count; ++index) {
+    const int fd = index == 0 ? connect_when_ready(path) : ipc_connect(path);
+    epoll_event event{EPOLLIN, {.u64 = static_cast<std::uint64_t>(index)}};
+    ok = fd >= 0 && send_attach(fd, "") &&
+         epoll_ctl(clients.epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+    clients.fds.push_back(fd);
+  }
+
+  // Round 0 is the state every client is sent on attach
+  std::vector<steady_clock::duration> latencies;
+  latencies.reserve(static_cast<std::size_t>(client_count) * rounds);
+  ok = ok && collect(clients, 0, steady_clock::now(), latencies);
+  latencies.clear();
+  const auto started = steady_clock::now();
+  for (int round = 1; ok && round <= rounds; ++round) {
+    const auto sent = steady_clock::now();
+    ok = send_command(clients.fds[0], MessageType::kStartPause) &&
+         collect(clients, round, sent, latencies);
+  }
+  const auto elapsed = steady_clock::now() - started;
+
+  for (const int fd : clients.fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  stop_daemon(daemon);
+  if (!ok) {
+    std::fprintf(stderr, "bench_fanout: lost clients or timed out\n");
+    return 1;
+  }
+
+  std::ranges::sort(latencies);
+  const auto at = [&](double quantile) {
+    return micros(latencies[static_cast<std::size_t>(
+        quantile * static_cast<double>(latencies.size() - 1))]);
+  };
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%d clients, %d events, %zu shard(s)\n", client_count, rounds,
+              shards);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("delivery latency us: p50 %.1f  p99 %.1f  max %.1f\n", at(0.5),
+              at(0.99), micros(latencies.back()));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("deliveries per second: %.0f\n",
+              static_cast<double>(latencies.size()) /
+                  duration<double>(elapsed).count());
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Times the menu's type-to-filter over OPTIONS generated entries (100,000 by
+// default): every keystroke of a few queries, typed and then erased, must
+// narrow the list within one 60 Hz frame. Prints the slowest keystroke per
+// query and exits with 1 if any went over the frame.
+//
+//   bench_fuzzy [OPTIONS]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "fuzzy.h"
+
+using namespace std::chrono;
+
+namespace {
+constexpr std::size_t kDefaultOptions = 100000;
+constexpr auto kFrame = duration<double>(1.0 / 60);
+constexpr std::array<std::string_view, 18> kWords = {
+    "Study",   "review", "Chapter", "notes",   "Linear", "algebra",
+    "history", "Essay",  "physics", "lab",     "Report", "reading",
+    "Exam",    "prep",   "project", "Meeting", "draft",  "outline"};
+// The queries: a letter every option has, which keeps the whole list; one
+// that narrows to about a quarter; a long one whose later letters each scan
+// what is left; and one that matches nothing from its first letter
+constexpr std::array<std::string_view, 4> kQueries = {"e", "srn",
+                                                    "chapter notes 9", "zzz"};
+
+// Option names like "Linear review lab 48213", a few words of mixed case
+// and a number, as a long project or file list would hold
+std::vector<std::string> make_options(std::size_t count) {
+  std::vector<std::string> options;
+  options.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string name;
+    const std::size_t words = 2 + (i % 3);
+    for (std::size_t word = 0; word < words; ++word) {
+      name += kWords[(i * (word + 7) + word * 5) % kWords.size()];
+      name += ' ';
+    }
+    name += std::to_string(i);
+    options.push_back(std::move(name));
+  }
+  return options;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const std::size_t count =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : kDefaultOptions;
+  const std::vector<std::string> options = make_options(count);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%zu options, frame %.1f ms\n%-18s %10s %14s %14s\n", count,
+              duration<double, std::milli>(kFrame).count(), "query",
+              "matches", "slowest key us", "slowest bs us");
+  bool within_frame = true;
+  for (const std::string_view query : kQueries) {
+    FuzzyFilter filter = fuzzy_filter_make(options.size());
+    steady_clock::duration slowest_key{};
+    steady_clock::duration slowest_erase{};
+    for (const char letter : query) {
+      const auto started = steady_clock::now();
+      fuzzy_filter_push(filter, options, letter);
+      slowest_key = std::max(slowest_key, steady_clock::now() - started);
+    }
+    const std::size_t matches = fuzzy_filter_matches(filter).size();
+    while (!filter.query.empty()) {
+      const auto started = steady_clock::now();
+      fuzzy_filter_pop(filter);
+      slowest_erase = std::max(slowest_erase, steady_clock::now() - started);
+    }
+    within_frame =
+        within_frame && slowest_key < kFrame && slowest_erase < kFrame;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::printf("%-18.*s %10zu %14.1f %14.1f\n",
+                static_cast<int>(query.size()), query.data(), matches,
+                duration<double, std::micro>(slowest_key).count(),
+                duration<double, std::micro>(slowest_erase).count());
+  }
+  if (!within_frame) {
+    std::fprintf(stderr, "bench_fuzzy: a keystroke took longer than a frame\n");
+    return 1;
+  }
+  return 0;
+}
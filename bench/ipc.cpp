@@ -0,0 +1,122 @@
+// Measures the wire protocol's throughput in messages per second: encoding
+// kState events with ipc_encode_event, and receiving them through a
+// FrameBuffer from a socketpair, once including the read(2) calls and once
+// counting only the framing (FrameBuffer::next) and ipc_decode_event.
+//
+//   bench_ipc [MESSAGES]
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+
+#include "ipc.h"
+#include "session.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr long long kDefaultMessages = 20'000'000;
+// A kState frame is 24 bytes; this many fill one FrameBuffer read
+constexpr std::size_t kBatch = 42;
+constexpr std::size_t kStateFrameLength = 24;
+
+SessionEvent event_for(long long index) {
+  return {(index & 1) != 0, SessionStatus::kRunning, 25min, true,
+          milliseconds(index % 1'500'000)};
+}
+
+double per_second(long long messages, steady_clock::duration elapsed) {
+  return static_cast<double>(messages) / duration<double>(elapsed).count();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const long long messages =
+      argc > 1 ? std::atoll(argv[1]) : kDefaultMessages;
+  const long long batches = messages / static_cast<long long>(kBatch);
+  const long long total = batches * static_cast<long long>(kBatch);
+  if (batches < 1) {
+    std::fprintf(stderr, "bench_ipc: need at least %zu messages\n", kBatch);
+    return 1;
+  }
+
+  // Encode: the daemon's cost per state change, before any fan-out
+  std::array<std::uint8_t, kBatch * kStateFrameLength> block{};
+  if (std::array<std::uint8_t, kMaxMessageLength> probe{};
+      ipc_encode_event(event_for(0), probe) != kStateFrameLength) {
+    std::fprintf(stderr, "bench_ipc: kState frame length changed\n");
+    return 1;
+  }
+  std::uint64_t checksum = 0;
+  auto started = steady_clock::now();
+  for (long long index = 0; index < total; ++index) {
+    const auto slot = static_cast<std::size_t>(index) % kBatch;
+    const std::size_t length = ipc_encode_event(
+        event_for(index),
+        std::span(block).subspan(slot * kStateFrameLength, kStateFrameLength));
+    checksum += length + block.at(slot * kStateFrameLength + 4);
+  }
+  const auto encoding = steady_clock::now() - started;
+
+  // Receive: one batch written, then read and decoded by the client side
+  std::array<int, 2> pair{};
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()) != 0) {
+    std::perror("bench_ipc: socketpair");
+    return 1;
+  }
+  // The reading side drains until EAGAIN, as a client does
+  fcntl(pair[1], F_SETFL, fcntl(pair[1], F_GETFL) | O_NONBLOCK);
+  FrameBuffer input;
+  steady_clock::duration decoding{};
+  started = steady_clock::now();
+  for (long long batch = 0; batch < batches; ++batch) {
+    if (write(pair[0], block.data(), block.size()) !=
+            static_cast<ssize_t>(block.size()) ||
+        input.fill(pair[1]) == ReadResult::kClosed) {
+      std::fprintf(stderr, "bench_ipc: socketpair transfer failed\n");
+      return 1;
+    }
+    const auto framing = steady_clock::now();
+    Frame frame{};
+    SessionEvent event{};
+    std::size_t received = 0;
+    while (input.next(frame)) {
+      received += ipc_decode_event(frame, event) ? 1 : 0;
+      checksum += static_cast<std::uint64_t>(event.remaining.count());
+    }
+    decoding += steady_clock::now() - framing;
+    if (received != kBatch) {
+      std::fprintf(stderr, "bench_ipc: decoded %zu of %zu events\n", received,
+                   kBatch);
+      return 1;
+    }
+  }
+  const auto receiving = steady_clock::now() - started;
+  close(pair[0]);
+  close(pair[1]);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%lld kState messages (checksum %llu)\n", total,
+              static_cast<unsigned long long>(checksum));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("encode:                 %12.0f msg/s\n",
+              per_second(total, encoding));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("frame + decode:         %12.0f msg/s\n",
+              per_second(total, decoding));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("write + read + decode:  %12.0f msg/s\n",
+              per_second(total, receiving));
+  return 0;
+}
@@ -0,0 +1,174 @@
+// Compares the terminal backends on the timer screen: each one draws the
+// countdown frames of a 50-minute session (one per displayed second or bar
+// step, up to FRAMES) into a pseudo-terminal, then a batch of full repaints,
+// and reports the write(2) calls and bytes it cost per frame. Counts come
+// from /proc/self/io, so the benchmark needs Linux; ncurses cannot observe
+// its own writes otherwise.
+//
+//   bench_renderers [FRAMES]
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "clock.h"
+#include "frame.h"
+#include "keymap.h"
+#include "pomodoro.h"
+#include "renderer.h"
+#include "screen.h"
+#include "session.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int kDefaultFrames = 3000;
+constexpr SessionTime kSession{50min};
+constexpr int kRepaints = 100;
+constexpr unsigned short kRows = 24;
+constexpr unsigned short kCols = 80;
+constexpr std::array<const char*, 2> kBackends = {"ncurses", "ansi"};
+
+struct IoCounters {
+  std::uint64_t writes;
+  std::uint64_t bytes;
+};
+
+struct Result {
+  IoCounters tick;
+  int tick_frames;
+  IoCounters repaint;
+  int repaint_frames;
+};
+
+// write(2) calls and bytes written so far by this process
+IoCounters io_counters() {
+  IoCounters counters{};
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  std::uint64_t value = 0;
+  while (io >> key >> value) {
+    if (key == "syscw:") {
+      counters.writes = value;
+    } else if (key == "wchar:") {
+      counters.bytes = value;
+    }
+  }
+  return counters;
+}
+
+IoCounters since(const IoCounters& before) {
+  const IoCounters now = io_counters();
+  return {now.writes - before.writes, now.bytes - before.bytes};
+}
+
+// Runs in the child, with the pseudo-terminal as stdin and stdout
+Result measure(const char* backend, int frames) {
+  std::setlocale(LC_CTYPE, "C.UTF-8");
+  VirtualClock clock;
+  auto renderer = make_renderer(backend);
+  const Keymap keymap = keymap_defaults();
+  Screen screen(*renderer, keymap, clock);
+  SessionState session = session_make(kSession);
+  session_apply(session, SessionCommand::kStartPause, kSession, kSession,
+                clock.now());
+  const int steps = screen.layout().bar_steps;
+  TimerView shown = timer_view(session.tick, clock.now(), steps);
+  draw(screen, shown, session.status);
+
+  Result result{};
+  IoCounters before = io_counters();
+  while (result.tick_frames < frames &&
+         !timer_tick(session.tick, clock.now())) {
+    clock.sleep_until(next_frame_at(session.tick, clock.now(), steps));
+    shown = timer_view(session.tick, clock.now(), steps);
+    draw_clock(screen, shown);
+    ++result.tick_frames;
+  }
+  result.tick = since(before);
+
+  before = io_counters();
+  for (; result.repaint_frames < kRepaints; ++result.repaint_frames) {
+    screen.invalidate();
+    draw(screen, shown, session.status);
+  }
+  result.repaint = since(before);
+  return result;
+}
+
+// Runs backend in a child on a fresh pseudo-terminal, draining its output
+// so it never blocks, and collects the child's measurements over a pipe
+bool run(const char* backend, int frames, Result& result) {
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    return false;
+  }
+  const winsize size{kRows, kCols, 0, 0};
+  ioctl(master, TIOCSWINSZ, &size);
+  std::array<int, 2> results{};
+  if (pipe(results.data()) != 0) {
+    return false;
+  }
+  const pid_t child = fork();
+  if (child == 0) {
+    const int slave = open(ptsname(master), O_RDWR);
+    dup2(slave, STDIN_FILENO);
+    dup2(slave, STDOUT_FILENO);
+    close(master);
+    close(results[0]);
+    setenv("TERM", "xterm-256color", 0);
+    const Result measured = measure(backend, frames);
+    const ssize_t sent = write(results[1], &measured, sizeof(measured));
+    _exit(sent == sizeof(measured) ? 0 : 1);
+  }
+  close(results[1]);
+  std::array<char, 4096> drain{};
+  while (read(master, drain.data(), drain.size()) > 0) {
+  }
+  const bool received =
+      read(results[0], &result, sizeof(result)) == sizeof(result);
+  close(results[0]);
+  close(master);
+  int status = 0;
+  waitpid(child, &status, 0);
+  return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+double per_frame(std::uint64_t total, int frames) {
+  return static_cast<double>(total) / frames;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const int frames = argc > 1 ? std::atoi(argv[1]) : kDefaultFrames;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%-8s %14s %14s %14s %14s\n", "backend", "tick writes",
+              "tick bytes", "repaint writes", "repaint bytes");
+  for (const char* backend : kBackends) {
+    Result result{};
+    if (!run(backend, frames, result)) {
+      std::fprintf(stderr, "bench_renderers: %s failed\n", backend);
+      return 1;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::printf("%-8s %14.2f %14.1f %14.2f %14.1f\n", backend,
+                per_frame(result.tick.writes, result.tick_frames),
+                per_frame(result.tick.bytes, result.tick_frames),
+                per_frame(result.repaint.writes, result.repaint_frames),
+                per_frame(result.repaint.bytes, result.repaint_frames));
+  }
+  return 0;
+}
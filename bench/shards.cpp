@@ -0,0 +1,206 @@
+// Shows how the daemon scales with its shard count: for 1, 2, 4, ... up to
+// MAX_SHARDS event loops it forks a daemon, attaches CLIENTS connections to
+// as many named timers (spread over the shards by name), and has every client
+// toggle its timer ROUNDS times, waiting for each reply before the next. The
+// clients are driven by one thread per shard so the daemon, not this side,
+// is the bottleneck. Reports commands per second and the p50/p99 time from
+// sending a command to receiving its event. Scaling needs as many free cores
+// as shards plus client threads. The clients wait on epoll, so the benchmark
+// needs Linux.
+//
+//   bench_shards [MAX_SHARDS] [CLIENTS] [ROUNDS]
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "daemon_harness.h"
+#include "ipc.h"
+
+using namespace std::chrono;
+
+namespace {
+constexpr std::size_t kDefaultClients = 4096;
+constexpr int kDefaultRounds = 20;
+constexpr int kMaxEvents = 256;
+constexpr int kEventTimeoutMs = 10000;
+
+struct Client {
+  int fd = -1;
+  FrameBuffer input;
+  steady_clock::time_point sent;
+  bool replied;
+};
+
+// Reads what the ready clients were sent; marks a client replied once a
+// kState arrives and records how long it took. False on timeout or a lost
+// connection.
+bool collect(int epoll_fd, std::span<Client> clients,
+             std::vector<steady_clock::duration>& latencies) {
+  std::array<epoll_event, kMaxEvents> ready{};
+  std::size_t waiting = clients.size();
+  while (waiting > 0) {
+    const int count =
+        epoll_wait(epoll_fd, ready.data(), kMaxEvents, kEventTimeoutMs);
+    if (count <= 0) {
+      return false;
+    }
+    const auto arrived = steady_clock::now();
+    for (const epoll_event& event : std::span(ready.data(), count)) {
+      Client& client = clients[event.data.u64];
+      if (client.input.fill(client.fd) == ReadResult::kClosed) {
+        return false;
+      }
+      Frame frame{};
+      while (client.input.next(frame)) {
+        if (frame.type == MessageType::kState && !client.replied) {
+          client.replied = true;
+          latencies.push_back(arrived - client.sent);
+          --waiting;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// One client thread: attaches its clients, then runs the rounds over them;
+// busy is how long the rounds took, connection setup excluded
+bool drive(std::span<Client> clients, std::size_t first_timer,
+           const std::string& path, int rounds,
+           std::vector<steady_clock::duration>& latencies,
+           steady_clock::duration& busy) {
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  bool ok = epoll_fd >= 0;
+  for (std::size_t index = 0; ok && index < clients.size(); ++index) {
+    Client& client = clients[index];
+    client.fd = ipc_connect(path);
+    client.sent = steady_clock::now();
+    epoll_event event{EPOLLIN, {.u64 = index}};
+    ok = client.fd >= 0 &&
+         send_attach(client.fd,
+                     "bench-" + std::to_string(first_timer + index)) &&
+         epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event) == 0;
+  }
+  // The event each client is sent on attach is not counted
+  std::vector<steady_clock::duration> attached;
+  ok = ok && collect(epoll_fd, clients, attached);
+  const auto started = steady_clock::now();
+  for (int round = 0; ok && round < rounds; ++round) {
+    for (Client& client : clients) {
+      client.replied = false;
+      client.sent = steady_clock::now();
+      ok = ok && send_command(client.fd, MessageType::kStartPause);
+    }
+    ok = ok && collect(epoll_fd, clients, latencies);
+  }
+  busy = steady_clock::now() - started;
+  for (const Client& client : clients) {
+    if (client.fd >= 0) {
+      close(client.fd);
+    }
+  }
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+  }
+  return ok;
+}
+
+double micros(steady_clock::duration value) {
+  return duration<double, std::micro>(value).count();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const std::size_t max_shards =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+               : std::max(std::thread::hardware_concurrency() / 2, 1U);
+  const std::size_t client_count =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : kDefaultClients;
+  const int rounds = argc > 3 ? std::atoi(argv[3]) : kDefaultRounds;
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  if (max_shards < 1 || client_count < max_shards || rounds < 1) {
+    std::fprintf(stderr,
+                 "usage: bench_shards [MAX_SHARDS] [CLIENTS] [ROUNDS]\n");
+    return 1;
+  }
+  if (!raise_descriptor_limit(client_count)) {
+    std::fprintf(stderr, "bench_shards: descriptor limit below %zu clients\n",
+                 client_count);
+    return 1;
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%zu clients, %d commands each\n%8s %14s %12s %12s\n",
+              client_count, rounds, "shards", "commands/s", "p50 us",
+              "p99 us");
+  const std::string path = bench_socket_path();
+  for (std::size_t shards = 1; shards <= max_shards; shards *= 2) {
+    const pid_t daemon = start_daemon(path, shards);
+    const int probe = connect_when_ready(path);
+    if (probe < 0) {
+      std::fprintf(stderr, "bench_shards: daemon did not start\n");
+      stop_daemon(daemon);
+      return 1;
+    }
+    close(probe);
+
+    std::vector<Client> clients(client_count);
+    std::vector<std::vector<steady_clock::duration>> latencies(shards);
+    std::vector<char> ok(shards, 0);
+    std::vector<steady_clock::duration> busy(shards);
+    std::vector<std::thread> threads;
+    const std::size_t share = client_count / shards;
+    for (std::size_t thread = 0; thread < shards; ++thread) {
+      const std::size_t first = thread * share;
+      const std::size_t count =
+          thread + 1 == shards ? client_count - first : share;
+      latencies[thread].reserve(count * static_cast<std::size_t>(rounds));
+      threads.emplace_back([&, thread, first, count] {
+        ok[thread] = drive(std::span(clients).subspan(first, count), first,
+                           path, rounds, latencies[thread], busy[thread])
+                         ? 1
+                         : 0;
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    // The rounds overlap across threads; the slowest sets the pace
+    const auto elapsed = std::ranges::max(busy);
+    stop_daemon(daemon);
+    if (std::ranges::count(ok, 0) != 0) {
+      std::fprintf(stderr, "bench_shards: lost clients or timed out\n");
+      return 1;
+    }
+
+    std::vector<steady_clock::duration> all;
+    for (const auto& part : latencies) {
+      all.insert(all.end(), part.begin(), part.end());
+    }
+    std::ranges::sort(all);
+    const auto at = [&](double quantile) {
+      return micros(all[static_cast<std::size_t>(
+          quantile * static_cast<double>(all.size() - 1))]);
+    };
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::printf("%8zu %14.0f %12.1f %12.1f\n", shards,
+                static_cast<double>(all.size()) /
+                    duration<double>(elapsed).count(),
+                at(0.5), at(0.99));
+  }
+  return 0;
+}
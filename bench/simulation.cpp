@@ -0,0 +1,68 @@
+// Runs a year (or argv[1] days) of study/break cycles through the real event
+// loop in virtual time, with a scripted user answering every prompt, and
+// reports how long the simulation took.
+//
+//   bench_simulation [DAYS]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "clock.h"
+#include "headless_renderer.h"
+#include "keymap.h"
+#include "pomodoro.h"
+#include "screen.h"
+#include "session.h"
+#include "status_file.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int kDefaultDays = 365;
+constexpr SessionTime kStudy{25min};
+constexpr SessionTime kBreak{5min};
+constexpr Clock::duration kAfterStudy = 2min;
+constexpr Clock::duration kAfterBreak = 1min;
+constexpr Clock::duration kCycle =
+    kStudy.length + kAfterStudy + kBreak.length + kAfterBreak;
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const int days = argc > 1 ? std::atoi(argv[1]) : kDefaultDays;
+  const auto cycles = static_cast<int>(days * 24h / kCycle);
+
+  VirtualClock clock;
+  const Clock::time_point start = clock.now();
+  clock.type_at(start, "s");
+  for (int cycle = 0; cycle < cycles; ++cycle) {
+    const Clock::time_point begin = start + (kCycle * cycle);
+    clock.type_at(begin + kStudy.length + kAfterStudy, " ");
+    clock.type_at(begin + kCycle, " ");
+  }
+  NullRenderer renderer(clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+
+  const auto wall_start = steady_clock::now();
+  pomodoro_event_loop(kStudy, kBreak, session, clock, screen, {}, status_file);
+  const duration<double> wall = steady_clock::now() - wall_start;
+
+  const OutputStats& output = *renderer.output_stats();
+  const auto simulated = duration_cast<hours>(clock.now() - start);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf(
+      "%d cycles, %lld h simulated in %.2f s (%.0fx real time)\n"
+      "%llu frames, %.0f ns per frame, %llu cells\n",
+      cycles, static_cast<long long>(simulated.count()), wall.count(),
+      duration<double>(clock.now() - start).count() / wall.count(),
+      static_cast<unsigned long long>(output.frames),
+      wall.count() * 1e9 / static_cast<double>(output.frames),
+      static_cast<unsigned long long>(output.cells));
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Shows how TimerWheel's costs scale with the number of pending timers, from
+// 10 to 1,000,000: nanoseconds per schedule, reschedule and cancel, per
+// timer expired while running the wheel through an hour, and per advance()
+// of one tick while every timer is still far off. The last column is the
+// wheel's main claim: a tick costs the same however many timers wait.
+//
+//   bench_timer_wheel [MAX_TIMERS]
+
+#include "timer_wheel.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "clock.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr std::size_t kDefaultMaxTimers = 1'000'000;
+constexpr std::size_t kFewestTimers = 10;
+constexpr std::uint32_t kSeed = 20240615;
+constexpr Clock::duration kSpread = 1h;
+// How far the expiry pass moves the wheel per advance()
+constexpr Clock::duration kExpiryStep = 1s;
+constexpr int kIdleTicks = 1'000'000;
+
+struct Costs {
+  double schedule;
+  double reschedule;
+  double cancel;
+  double expire;
+  double idle_tick;
+};
+
+double nanos_each(steady_clock::duration elapsed, std::size_t count) {
+  return duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(count);
+}
+
+// Deadlines spread evenly at random over kSpread after start + offset
+std::vector<Clock::time_point> deadlines(std::size_t count,
+                                         Clock::time_point start,
+                                         std::mt19937& random) {
+  std::uniform_int_distribution<Clock::duration::rep> offset(
+      0, kSpread.count() - 1);
+  std::vector<Clock::time_point> result(count);
+  for (Clock::time_point& deadline : result) {
+    deadline = start + Clock::duration(offset(random));
+  }
+  return result;
+}
+
+Costs measure(std::size_t count) {
+  std::mt19937 random(kSeed);
+  const Clock::time_point start(1h);
+  const std::vector<Clock::time_point> first =
+      deadlines(count, start, random);
+  const std::vector<Clock::time_point> second =
+      deadlines(count, start, random);
+  TimerWheel wheel(start);
+  Costs costs{};
+
+  auto began = steady_clock::now();
+  for (std::size_t id = 0; id < count; ++id) {
+    wheel.schedule(static_cast<TimerId>(id), first[id]);
+  }
+  costs.schedule = nanos_each(steady_clock::now() - began, count);
+
+  began = steady_clock::now();
+  for (std::size_t id = 0; id < count; ++id) {
+    wheel.schedule(static_cast<TimerId>(id), second[id]);
+  }
+  costs.reschedule = nanos_each(steady_clock::now() - began, count);
+
+  // Every timer fires exactly once on the way through the hour
+  std::vector<TimerId> expired;
+  expired.reserve(count);
+  began = steady_clock::now();
+  for (Clock::time_point now = start; now <= start + kSpread;
+       now += kExpiryStep) {
+    wheel.advance(now, expired);
+  }
+  costs.expire = nanos_each(steady_clock::now() - began, count);
+  if (expired.size() != count) {
+    std::fprintf(stderr, "bench_timer_wheel: %zu of %zu timers expired\n",
+                 expired.size(), count);
+    std::exit(1);
+  }
+
+  // All pending an hour or more ahead: each tick finds nothing due
+  const Clock::time_point later = start + kSpread + 1s;
+  const std::vector<Clock::time_point> far =
+      deadlines(count, later + kSpread, random);
+  for (std::size_t id = 0; id < count; ++id) {
+    wheel.schedule(static_cast<TimerId>(id), far[id]);
+  }
+  expired.clear();
+  began = steady_clock::now();
+  for (int tick = 1; tick <= kIdleTicks; ++tick) {
+    wheel.advance(later + (TimerWheel::kTick * tick), expired);
+  }
+  costs.idle_tick = nanos_each(steady_clock::now() - began, kIdleTicks);
+  if (!expired.empty()) {
+    std::fprintf(stderr, "bench_timer_wheel: idle ticks expired timers\n");
+    std::exit(1);
+  }
+
+  began = steady_clock::now();
+  for (std::size_t id = 0; id < count; ++id) {
+    wheel.cancel(static_cast<TimerId>(id));
+  }
+  costs.cancel = nanos_each(steady_clock::now() - began, count);
+  return costs;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+  // Standard C++ argv usage
+  const std::size_t max_timers =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultMaxTimers;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%10s %14s %14s %14s %14s %14s\n", "timers", "schedule ns",
+              "reschedule ns", "cancel ns", "expire ns", "idle tick ns");
+  for (std::size_t count = kFewestTimers; count <= max_timers; count *= 10) {
+    const Costs costs = measure(count);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::printf("%10zu %14.1f %14.1f %14.1f %14.1f %14.1f\n", count,
+                costs.schedule, costs.reschedule, costs.cancel, costs.expire,
+                costs.idle_tick);
+  }
+  return 0;
+}
@@ -45,6 +45,7 @@
               cmake
               doxygen
               gcc
+              gtest
               just
               ncurses
               nix-output-monitor
@@ -65,12 +66,14 @@
             gcc
             ncurses
             cmake
+            gtest
           ]; # Dependencies
 
           # Build phase: configure and build with CMake, using all CPU cores
           buildPhase = ''
             cmake -S $src -B build
             cmake --build build -- -j$NIX_BUILD_CORES
+            ctest --test-dir build --output-on-failure
           '';
 
           # Install phase: copy the built binary to $out/bin
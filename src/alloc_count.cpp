@@ -0,0 +1,28 @@
+#include "alloc_count.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables) //
+// Process-wide state shared with the replaced allocation functions
+std::atomic<std::uint64_t> allocations{0};
+std::atomic<bool> hooks_installed{false};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+}  // namespace
+
+std::uint64_t allocation_count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+bool allocations_counted() {
+  return hooks_installed.load(std::memory_order_relaxed);
+}
+
+void allocation_hooks_install() {
+  hooks_installed.store(true, std::memory_order_relaxed);
+}
+
+void allocation_record() {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+}
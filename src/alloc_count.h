@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation counting for --stats and for pomodoro_test, which enforces
+// that the steady-state loop does not allocate. The counting replacements of
+// the global allocation functions live in alloc_hooks.cpp, which is linked
+// into the tests and, only when configured with
+// -DPOMODORO_COUNT_ALLOCATIONS=ON, into the binary; a normal build pays
+// nothing per allocation.
+
+// Number of global operator new calls since startup; 0 without the hooks
+std::uint64_t allocation_count();
+// Whether the hooks are linked into this program
+bool allocations_counted();
+
+// Called by the hooks
+void allocation_hooks_install();
+void allocation_record();
@@ -0,0 +1,37 @@
+// Counting replacements of the global allocation functions. Not part of
+// pomodoro_core: only the tests and builds configured with
+// -DPOMODORO_COUNT_ALLOCATIONS=ON link this file, so the atomic increment on
+// every allocation is opt-in.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_count.h"
+
+namespace {
+// Tells --stats the count is real. The atomics it sets are constant
+// initialized, so this may run before or after other static initializers.
+const bool kInstalled = (allocation_hooks_install(), true);
+}  // namespace
+
+// The array and nothrow forms of operator new and every operator delete form
+// forward to these by default
+void* operator new(std::size_t size) {
+  allocation_record();
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc) // operator new replacement
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc) // operator delete replacement
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc) // operator delete replacement
+  std::free(ptr);
+}
@@ -0,0 +1,137 @@
+#include "ansi_renderer.h"
+
+#include <ncurses.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <string_view>
+
+#include "utf8.h"
+
+namespace {
+constexpr std::size_t kFrameReserve = 16 * 1024;
+constexpr int kFallbackRows = 24;
+constexpr int kFallbackCols = 80;
+constexpr std::string_view kEnterAltScreen =
+    "\x1b[?1049h\x1b[?25l\x1b[H\x1b[2J";
+constexpr std::string_view kLeaveAltScreen = "\x1b[m\x1b[?25h\x1b[?1049l";
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) //
+// Set from the SIGWINCH handler
+volatile std::sig_atomic_t resized = 0;
+
+void on_sigwinch(int /*signal*/) { resized = 1; }
+
+void append_number(std::string& out, int value) {
+  std::array<char, 16> digits{};
+  const auto result =
+      std::to_chars(digits.data(), digits.data() + digits.size(), value);
+  out.append(digits.data(), result.ptr);
+}
+}  // namespace
+
+// Terminal setup is queued in front of the first frame rather than written
+// on its own, so that frame too goes out in a single write
+AnsiRenderer::AnsiRenderer() {
+  frame_.reserve(kFrameReserve);
+  frame_ += kEnterAltScreen;
+  struct sigaction action{};
+  action.sa_handler = on_sigwinch;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGWINCH, &action, nullptr);
+}
+
+AnsiRenderer::~AnsiRenderer() {
+  frame_ += kLeaveAltScreen;
+  write_all(frame_);
+}
+
+TermSize AnsiRenderer::size() const {
+  winsize window{};
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) != 0 || window.ws_row == 0) {
+    return {kFallbackRows, kFallbackCols};
+  }
+  return {window.ws_row, window.ws_col};
+}
+
+// Appends a cursor move (skipped when the cursor is already there), an
+// attribute change when needed, and the text
+void AnsiRenderer::put(int row, int col, std::string_view text, Attr attr) {
+  if (row != cursor_row_ || col != cursor_col_) {
+    frame_ += "\x1b[";
+    append_number(frame_, row + 1);
+    frame_ += ';';
+    append_number(frame_, col + 1);
+    frame_ += 'H';
+  }
+  if (attr != attr_) {
+    frame_ += attr == Attr::kReverse ? "\x1b[7m" : "\x1b[27m";
+    attr_ = attr;
+  }
+  frame_ += text;
+  const auto cells = utf8_length(text);
+  stats_.cells += cells;
+  cursor_row_ = row;
+  cursor_col_ = col + static_cast<int>(cells);
+}
+
+// Sends the whole frame with one write(2); more are only issued if the
+// kernel accepts a partial write
+void AnsiRenderer::flush() {
+  ++stats_.frames;
+  if (frame_.empty()) {
+    return;
+  }
+  const std::uint64_t writes_before = stats_.writes;
+  write_all(frame_);
+  frame_.clear();
+  if (stats_.writes - writes_before > 1) {
+    ++stats_.frames_over_budget;
+  }
+}
+
+void AnsiRenderer::clear() {
+  frame_ += "\x1b[m\x1b[2J";
+  attr_ = Attr::kNormal;
+  cursor_row_ = -1;
+  cursor_col_ = -1;
+}
+
+// Reports a pending resize before any key so the next frame picks up the
+// new size
+int AnsiRenderer::read_key(bool block) {
+  if (resized != 0) {
+    resized = 0;
+    return KEY_RESIZE;
+  }
+  const int key = input_.read_key(block);
+  if (key == ERR && resized != 0) {
+    resized = 0;
+    return KEY_RESIZE;
+  }
+  return key;
+}
+
+int AnsiRenderer::input_fd() const { return input_.fd(); }
+
+bool AnsiRenderer::unicode() const { return utf8_locale(); }
+
+// Writes the whole buffer, counting every write(2) issued
+void AnsiRenderer::write_all(std::string_view bytes) {
+  while (!bytes.empty()) {
+    const ssize_t written = write(STDOUT_FILENO, bytes.data(), bytes.size());
+    ++stats_.writes;
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    stats_.bytes += static_cast<std::uint64_t>(written);
+    bytes.remove_prefix(static_cast<std::size_t>(written));
+  }
+}
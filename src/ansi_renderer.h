@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "renderer.h"
+#include "tty_input.h"
+
+// Backend that skips curses entirely: it reads keys through TtyInput,
+// encodes each frame as one buffer of ANSI escape sequences and writes it out
+// when the frame is flushed
+class AnsiRenderer final : public Renderer {
+ public:
+  AnsiRenderer();
+  AnsiRenderer(const AnsiRenderer&) = delete;
+  AnsiRenderer& operator=(const AnsiRenderer&) = delete;
+  AnsiRenderer(AnsiRenderer&&) = delete;
+  AnsiRenderer& operator=(AnsiRenderer&&) = delete;
+  ~AnsiRenderer() override;
+
+  [[nodiscard]] TermSize size() const override;
+  void put(int row, int col, std::string_view text, Attr attr) override;
+  void flush() override;
+  void clear() override;
+  int read_key(bool block) override;
+  [[nodiscard]] int input_fd() const override;
+  [[nodiscard]] bool unicode() const override;
+  [[nodiscard]] const OutputStats* output_stats() const override {
+    return &stats_;
+  }
+
+ private:
+  void write_all(std::string_view bytes);
+
+  TtyInput input_;
+  std::string frame_;
+  int cursor_row_ = -1;
+  int cursor_col_ = -1;
+  Attr attr_ = Attr::kNormal;
+  OutputStats stats_{};
+};
@@ -0,0 +1,225 @@
+#include "checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+using namespace std::chrono;
+
+namespace {
+constexpr int kCheckpointVersion = 1;
+constexpr std::size_t kMaxPathLength = 4096;
+constexpr std::size_t kMaxCheckpointLength = 512;
+constexpr mode_t kCheckpointMode = 0600;
+
+long long to_unix_ms(system_clock::time_point point) {
+  return duration_cast<milliseconds>(point.time_since_epoch()).count();
+}
+}  // namespace
+
+// Converts the countdown to wall-clock terms at the current instant
+Checkpoint checkpoint_make(const SessionTime& pomodoro, const SessionTime& brk,
+                           const SessionState& session, Clock::time_point now,
+                           system_clock::time_point wall_now) {
+  const auto remaining =
+      ceil<milliseconds>(timer_remaining(session.tick, now));
+  return {pomodoro.length,
+          brk.length,
+          session.on_break,
+          session.status,
+          session.tick.total,
+          remaining,
+          session.tick.counting,
+          wall_now + remaining};
+}
+
+std::string checkpoint_default_path(std::string_view name) {
+  if (const char* state = std::getenv("XDG_STATE_HOME");
+      state != nullptr && *state != '\0') {
+    return std::string(state) + "/pomodoro/" + std::string(name);
+  }
+  if (const char* home = std::getenv("HOME");
+      home != nullptr && *home != '\0') {
+    return std::string(home) + "/.local/state/pomodoro/" + std::string(name);
+  }
+  return {};
+}
+
+// Writes the whole file to a temporary next to path and renames it over
+// path, so a crash at any point leaves either the old or the new checkpoint.
+// Formats into fixed buffers: it runs from the event loop on every state
+// change, which must not allocate.
+bool checkpoint_save(const std::string& path, const Checkpoint& checkpoint) {
+  std::array<char, kMaxPathLength> temp_path{};
+  const int path_length = std::snprintf(temp_path.data(), temp_path.size(),
+                                        "%s.tmp", path.c_str());
+  if (path_length < 0 ||
+      static_cast<std::size_t>(path_length) >= temp_path.size()) {
+    return false;
+  }
+  std::array<char, kMaxCheckpointLength> text{};
+  const int length = std::snprintf(
+      text.data(), text.size(),
+      "version %d\nstudy %lld\nbreak %lld\non_break %d\nstatus %d\n"
+      "total %lld\nremaining_ms %lld\ncounting %d\ndeadline_unix_ms %lld\n",
+      kCheckpointVersion, static_cast<long long>(checkpoint.study.count()),
+      static_cast<long long>(checkpoint.brk.count()),
+      checkpoint.on_break ? 1 : 0, static_cast<int>(checkpoint.status),
+      static_cast<long long>(checkpoint.total.count()),
+      static_cast<long long>(checkpoint.remaining.count()),
+      checkpoint.counting ? 1 : 0, to_unix_ms(checkpoint.deadline));
+  if (length < 0 || static_cast<std::size_t>(length) >= text.size()) {
+    return false;
+  }
+  int fd = open(temp_path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                kCheckpointMode);
+  if (fd < 0 && errno == ENOENT) {
+    // First save: create the state directory
+    std::error_code error;
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), error);
+    fd = open(temp_path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+              kCheckpointMode);
+  }
+  if (fd < 0) {
+    return false;
+  }
+  std::string_view remaining(text.data(), static_cast<std::size_t>(length));
+  bool ok = true;
+  while (ok && !remaining.empty()) {
+    const ssize_t written = write(fd, remaining.data(), remaining.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    ok = written > 0;
+    if (ok) {
+      remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+  }
+  ok = ok && fsync(fd) == 0;
+  ok = close(fd) == 0 && ok;
+  if (!ok || std::rename(temp_path.data(), path.c_str()) != 0) {
+    unlink(temp_path.data());
+    return false;
+  }
+  return true;
+}
+
+// Reads a checkpoint written by checkpoint_save; anything missing, out of
+// range or from another format version is rejected
+bool checkpoint_load(const std::string& path, Checkpoint& checkpoint) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    return false;
+  }
+  long long version = 0;
+  long long study = 0;
+  long long brk = 0;
+  long long on_break = -1;
+  long long status = -1;
+  long long total = 0;
+  long long remaining = -1;
+  long long counting = -1;
+  long long deadline = 0;
+  std::string key;
+  long long value = 0;
+  while (in >> key >> value) {
+    if (key == "version") {
+      version = value;
+    } else if (key == "study") {
+      study = value;
+    } else if (key == "break") {
+      brk = value;
+    } else if (key == "on_break") {
+      on_break = value;
+    } else if (key == "status") {
+      status = value;
+    } else if (key == "total") {
+      total = value;
+    } else if (key == "remaining_ms") {
+      remaining = value;
+    } else if (key == "counting") {
+      counting = value;
+    } else if (key == "deadline_unix_ms") {
+      deadline = value;
+    }
+  }
+  const auto status_count =
+      static_cast<long long>(kSessionStatusText.size());
+  if (version != kCheckpointVersion || study <= 0 || brk <= 0 || total <= 0 ||
+      (on_break != 0 && on_break != 1) || status < 0 ||
+      status >= status_count || remaining < 0 ||
+      (counting != 0 && counting != 1)) {
+    return false;
+  }
+  checkpoint = {seconds(study),
+                seconds(brk),
+                on_break == 1,
+                static_cast<SessionStatus>(status),
+                seconds(total),
+                std::min(milliseconds(remaining), milliseconds(seconds(total))),
+                counting == 1,
+                system_clock::time_point(milliseconds(deadline))};
+  return true;
+}
+
+// Rebuilds the session at now. Time that passed while no process was
+// running counts against a session that was counting down.
+SessionState checkpoint_restore(const Checkpoint& checkpoint,
+                                Clock::time_point now,
+                                system_clock::time_point wall_now) {
+  SessionState session{checkpoint.on_break, timer_make(checkpoint.total),
+                       checkpoint.status};
+  if (checkpoint.counting) {
+    session.tick.remaining = std::clamp<steady_clock::duration>(
+        checkpoint.deadline - wall_now, steady_clock::duration::zero(),
+        checkpoint.total);
+    timer_start(session.tick, now);
+  } else {
+    session.tick.remaining = checkpoint.remaining;
+  }
+  return session;
+}
+
+void checkpoint_remove(const std::string& path) { unlink(path.c_str()); }
+
+CheckpointLock::~CheckpointLock() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+// The lock file is left in place: unlinking it on exit would let a process
+// that opened it just before lock a file nobody else can see
+bool CheckpointLock::acquire(const std::string& path) {
+  const std::string lock_path = path + ".lock";
+  const int flags = O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW;
+  int fd = open(lock_path.c_str(), flags, kCheckpointMode);
+  if (fd < 0 && errno == ENOENT) {
+    std::error_code error;
+    std::filesystem::create_directories(
+        std::filesystem::path(path).parent_path(), error);
+    fd = open(lock_path.c_str(), flags, kCheckpointMode);
+  }
+  if (fd < 0) {
+    return false;
+  }
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    close(fd);
+    return false;
+  }
+  fd_ = fd;
+  return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include "clock.h"
+#include "session.h"
+
+// A session as written to disk so it can outlive the process. Times are
+// wall-clock: a steady_clock reading means nothing to another process.
+struct Checkpoint {
+  std::chrono::seconds study;
+  std::chrono::seconds brk;
+  bool on_break;
+  SessionStatus status;
+  std::chrono::seconds total;
+  // Time left while stopped or paused
+  std::chrono::milliseconds remaining;
+  bool counting;
+  // End of the countdown while counting
+  std::chrono::system_clock::time_point deadline;
+};
+
+Checkpoint checkpoint_make(const SessionTime& pomodoro, const SessionTime& brk,
+                           const SessionState& session, Clock::time_point now,
+                           std::chrono::system_clock::time_point wall_now);
+// Path of a checkpoint file: $XDG_STATE_HOME/pomodoro/<name>, falling back
+// to ~/.local/state/pomodoro/<name>. The TUI and the daemon use different
+// names so each resumes only its own session.
+std::string checkpoint_default_path(std::string_view name = "checkpoint");
+// Atomically replaces path with checkpoint, creating its directory; returns
+// false on error
+bool checkpoint_save(const std::string& path, const Checkpoint& checkpoint);
+bool checkpoint_load(const std::string& path, Checkpoint& checkpoint);
+SessionState checkpoint_restore(const Checkpoint& checkpoint,
+                                Clock::time_point now,
+                                std::chrono::system_clock::time_point wall_now);
+// Deletes the checkpoint once the session has been ended on purpose
+void checkpoint_remove(const std::string& path);
+
+// Exclusive ownership of a checkpoint for the life of a process, held as a
+// flock on the sibling file <path>.lock (saves replace the checkpoint itself,
+// so it cannot carry the lock). Only the owner may resume, save or remove the
+// checkpoint, so two timers on one account never share or delete each
+// other's session.
+class CheckpointLock {
+ public:
+  CheckpointLock() = default;
+  CheckpointLock(const CheckpointLock&) = delete;
+  CheckpointLock& operator=(const CheckpointLock&) = delete;
+  CheckpointLock(CheckpointLock&&) = delete;
+  CheckpointLock& operator=(CheckpointLock&&) = delete;
+  ~CheckpointLock();
+
+  // Takes the lock, creating the state directory if needed; false if another
+  // process holds it or the lock file cannot be opened
+  bool acquire(const std::string& path);
+
+ private:
+  int fd_ = -1;
+};
@@ -0,0 +1,100 @@
+#include "client.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "ipc.h"
+#include "keymap.h"
+#include "session.h"
+#include "shutdown.h"
+#include "timer_screen.h"
+
+namespace {
+void send_command(int fd, MessageType command) {
+  std::array<std::uint8_t, kMaxMessageLength> message{};
+  const std::size_t length = ipc_encode_command(command, message);
+  ipc_send(fd, std::span<const std::uint8_t>(message.data(), length));
+}
+
+// Applies every event received; false once the daemon has gone or broken
+// the protocol
+bool read_events(int fd, FrameBuffer& input, SessionState& session,
+                 Clock::time_point now, bool& received) {
+  while (true) {
+    const ReadResult result = input.fill(fd);
+    Frame frame{};
+    SessionEvent event{};
+    while (input.next(frame)) {
+      if (ipc_decode_event(frame, event)) {
+        session = session_event_state(event, now);
+        received = true;
+      }
+    }
+    if (input.malformed() || result == ReadResult::kClosed) {
+      return false;
+    }
+    if (result == ReadResult::kDrained) {
+      return true;
+    }
+  }
+}
+}  // namespace
+
+ClientExit client_event_loop(int fd, std::string_view timer, Clock& clock,
+                             Screen& screen, LoopStats* stats) {
+  FrameBuffer input;
+  SessionState session{};
+  // The daemon answers kAttach with the timer's state
+  std::array<std::uint8_t, kMaxMessageLength> hello{};
+  const std::size_t length = ipc_encode_attach(timer, hello);
+  if (length == 0 ||
+      !ipc_send(fd, std::span<const std::uint8_t>(hello.data(), length))) {
+    return ClientExit::kDisconnected;
+  }
+  bool received = false;
+  const std::array<int, 2> hello_fds = {fd, shutdown_fd()};
+  while (!received) {
+    clock.wait_readable(hello_fds, Clock::time_point::max());
+    if (shutdown_signal() != 0) {
+      return ClientExit::kShutdown;
+    }
+    if (!read_events(fd, input, session, clock.now(), received)) {
+      return ClientExit::kDisconnected;
+    }
+  }
+
+  // Same cycle as the local loop; keys become commands for the daemon and
+  // the state comes back as events on fd
+  TimerScreen timer_screen(clock, screen, stats);
+  timer_screen.start(session);
+  while (true) {
+    timer_screen.wait(session, fd);
+    bool quit = false;
+    for (Action action{}; !quit && timer_screen.next_action(action);) {
+      if (action == Action::kQuit) {
+        send_command(fd, MessageType::kQuit);
+        quit = true;
+      } else if (action == Action::kStartPause) {
+        send_command(fd, MessageType::kStartPause);
+      } else if (action == Action::kReset) {
+        send_command(fd, MessageType::kReset);
+      }
+    }
+    bool received_now = false;
+    const bool connected =
+        read_events(fd, input, session, clock.now(), received_now);
+    timer_screen.record_wakeup();
+    if (quit) {
+      return ClientExit::kQuit;
+    }
+    if (shutdown_signal() != 0) {
+      return ClientExit::kShutdown;
+    }
+    if (!connected) {
+      return ClientExit::kDisconnected;
+    }
+    timer_screen.render(session, received_now);
+  }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "clock.h"
+#include "screen.h"
+#include "stats.h"
+
+// How an attached TUI session ended
+enum class ClientExit : std::uint8_t { kQuit, kShutdown, kDisconnected };
+
+// Shows the daemon's session on screen: keys are sent to the daemon as
+// commands and the display follows the state events it sends back. Between
+// events the countdown is rendered from the local clock, so the connection
+// is silent while the timer runs. Quitting detaches and leaves the daemon's
+// timer running. An empty timer name shows the daemon's own session.
+ClientExit client_event_loop(int fd, std::string_view timer, Clock& clock,
+                             Screen& screen, LoopStats* stats = nullptr);
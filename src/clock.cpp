@@ -0,0 +1,106 @@
+#include "clock.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+// Input plus the shutdown pipe, with room to spare
+constexpr std::size_t kMaxWaitFds = 4;
+}  // namespace
+
+Clock::time_point SteadyClock::now() const {
+  return std::chrono::steady_clock::now();
+}
+
+void SteadyClock::sleep_until(time_point deadline) {
+  std::this_thread::sleep_until(deadline);
+}
+
+// Sleeps in poll() so the process only wakes for input, signals or the
+// deadline
+bool SteadyClock::wait_readable(std::span<const int> fds, time_point deadline) {
+  const int timeout_ms = poll_timeout_ms(deadline, now());
+  std::array<pollfd, kMaxWaitFds> pfds{};
+  const auto count = std::min(fds.size(), pfds.size());
+  for (std::size_t i = 0; i < count; ++i) {
+    pfds.at(i) = {fds[i], POLLIN, 0};
+  }
+  const int result = poll(pfds.data(), count, timeout_ms);
+  // EINTR (e.g. SIGWINCH) is reported as readable so curses can deliver
+  // KEY_RESIZE to the caller
+  return result != 0;
+}
+
+// Rounds up so a poll() never wakes just before the deadline; -1 (wait
+// forever) for time_point::max()
+int poll_timeout_ms(Clock::time_point deadline, Clock::time_point now) {
+  if (deadline == Clock::time_point::max()) {
+    return -1;
+  }
+  const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+      std::max(deadline - now, Clock::duration::zero()));
+  return static_cast<int>(std::min<std::chrono::milliseconds::rep>(
+      wait.count(), std::numeric_limits<int>::max()));
+}
+
+VirtualClock::VirtualClock(time_point start) : now_(start) {
+  if (pipe(input_.data()) != 0) {
+    input_ = {-1, -1};
+  }
+}
+
+VirtualClock::~VirtualClock() {
+  for (const int fd : input_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+// Jumps straight to the deadline; time never runs backwards
+void VirtualClock::sleep_until(time_point deadline) {
+  if (deadline > now_) {
+    now_ = deadline;
+  }
+}
+
+// Only scripted input can make a descriptor readable in virtual time: the
+// wait jumps to the next keystroke due by the deadline, or to the deadline
+bool VirtualClock::wait_readable(std::span<const int> fds,
+                                 time_point deadline) {
+  const bool watching_input =
+      input_[0] >= 0 && std::ranges::find(fds, input_[0]) != fds.end();
+  if (watching_input && !script_.empty() &&
+      script_.begin()->first <= deadline) {
+    const auto next = script_.begin();
+    sleep_until(next->first);
+    const std::string& keys = next->second;
+    // Scripts are short; a pipe holds far more than one step of one
+    const ssize_t written = write(input_[1], keys.data(), keys.size());
+    script_.erase(next);
+    return written > 0;
+  }
+  if (watching_input && script_.empty() && deadline == time_point::max() &&
+      input_[1] >= 0) {
+    close(input_[1]);
+    input_[1] = -1;
+    return true;
+  }
+  if (deadline != time_point::max()) {
+    sleep_until(deadline);
+  }
+  return false;
+}
+
+void VirtualClock::type_at(time_point at, std::string_view keys) {
+  script_.emplace(at, std::string(keys));
+}
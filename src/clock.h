@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Time source for the timer engine and event loop. Everything that needs the
+// current time or has to wait goes through a Clock so simulations can swap in
+// a VirtualClock and run sessions without real waiting. A deadline of
+// time_point::max() means "no deadline".
+class Clock {
+ public:
+  using time_point = std::chrono::steady_clock::time_point;
+  using duration = std::chrono::steady_clock::duration;
+
+  Clock() = default;
+  Clock(const Clock&) = delete;
+  Clock& operator=(const Clock&) = delete;
+  Clock(Clock&&) = delete;
+  Clock& operator=(Clock&&) = delete;
+  virtual ~Clock() = default;
+
+  [[nodiscard]] virtual time_point now() const = 0;
+  virtual void sleep_until(time_point deadline) = 0;
+  // Blocks until one of fds is readable or the deadline passes; returns true
+  // when the caller should check them (input pending or a signal arrived).
+  // Negative descriptors are ignored.
+  virtual bool wait_readable(std::span<const int> fds,
+                             time_point deadline) = 0;
+};
+
+// Real time backed by std::chrono::steady_clock
+class SteadyClock final : public Clock {
+ public:
+  [[nodiscard]] time_point now() const override;
+  void sleep_until(time_point deadline) override;
+  bool wait_readable(std::span<const int> fds,
+                     time_point deadline) override;
+};
+
+// Manually driven time: sleeping returns immediately after jumping to the
+// deadline, and advance() moves time forward by an arbitrary amount.
+// Keystrokes can be scripted at virtual instants; they are written to a
+// pipe, whose read end (input_fd()) a headless renderer reads, when a wait
+// on that descriptor reaches them. Once the script has run out, a wait that
+// would never end closes the pipe instead, so the UI sees end of input and
+// quits rather than spinning.
+class VirtualClock final : public Clock {
+ public:
+  explicit VirtualClock(time_point start = time_point{});
+  VirtualClock(const VirtualClock&) = delete;
+  VirtualClock& operator=(const VirtualClock&) = delete;
+  VirtualClock(VirtualClock&&) = delete;
+  VirtualClock& operator=(VirtualClock&&) = delete;
+  ~VirtualClock() override;
+
+  [[nodiscard]] time_point now() const override { return now_; }
+  void sleep_until(time_point deadline) override;
+  bool wait_readable(std::span<const int> fds,
+                     time_point deadline) override;
+  void advance(duration step) { now_ += step; }
+
+  // Delivers keys on input_fd() at the virtual instant at
+  void type_at(time_point at, std::string_view keys);
+  [[nodiscard]] int input_fd() const { return input_[0]; }
+
+ private:
+  time_point now_;
+  // Read and write ends of the input pipe; the write end is -1 once closed
+  std::array<int, 2> input_{-1, -1};
+  std::multimap<time_point, std::string> script_;
+};
+
+// poll() timeout in milliseconds until deadline
+int poll_timeout_ms(Clock::time_point deadline, Clock::time_point now);
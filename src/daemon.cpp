@@ -0,0 +1,521 @@
+#include "daemon.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "checkpoint.h"
+#include "ipc.h"
+#include "mpsc_queue.h"
+#include "outbox.h"
+#include "poller.h"
+#include "session.h"
+#include "shutdown.h"
+#include "status_file.h"
+#include "timer_manager.h"
+#include "wakeup.h"
+
+namespace {
+// Poller tags; clients are tagged with their slot plus kFirstClientTag
+constexpr std::uint64_t kListenTag = 0;
+constexpr std::uint64_t kShutdownTag = 1;
+constexpr std::uint64_t kWakeupTag = 2;
+constexpr std::uint64_t kFirstClientTag = 3;
+constexpr TimerId kNoTimer = std::numeric_limits<TimerId>::max();
+
+struct Client {
+  // -1 while the slot is free
+  int fd = -1;
+  // The timer the client is attached to, and its place in that timer's
+  // watcher list
+  TimerId timer = kNoTimer;
+  std::size_t watch_index = 0;
+  FrameBuffer input;
+  Outbox output{};
+  // Whether the poller is watching for room to write
+  bool want_write = false;
+};
+
+// Connected clients in reusable slots, so a slot number stays valid as the
+// poller tag of its client for as long as the connection lives. Each timer
+// keeps the list of slots attached to it, so an event only visits the
+// clients that show that timer.
+class ClientTable {
+ public:
+  explicit ClientTable(Poller& poller) : poller_(poller) {}
+
+  // Registers a connection, new or handed over by another shard, and
+  // attaches it to timer. Returns its slot, or -1 if it cannot be watched.
+  int add(Client client, TimerId timer) {
+    std::size_t slot = clients_.size();
+    if (!free_.empty()) {
+      slot = free_.back();
+      free_.pop_back();
+    } else {
+      clients_.emplace_back();
+    }
+    const std::uint64_t tag = kFirstClientTag + slot;
+    if (!poller_.add(client.fd, tag)) {
+      free_.push_back(slot);
+      return -1;
+    }
+    if (client.want_write) {
+      poller_.set_write(client.fd, tag, true);
+    }
+    clients_[slot] = std::move(client);
+    clients_[slot].timer = kNoTimer;
+    attach(slot, timer);
+    return static_cast<int>(slot);
+  }
+
+  // Unregisters the client and hands it back with its buffers, open
+  Client take(std::size_t slot) {
+    detach(slot);
+    poller_.remove(clients_[slot].fd);
+    Client client = std::move(clients_[slot]);
+    clients_[slot] = Client();
+    free_.push_back(slot);
+    return client;
+  }
+
+  // Closes the connection and frees its slot and buffers
+  void drop(std::size_t slot) { close(take(slot).fd); }
+
+  // Moves the client over to timer
+  void attach(std::size_t slot, TimerId timer) {
+    detach(slot);
+    if (timer >= watchers_.size()) {
+      watchers_.resize(static_cast<std::size_t>(timer) + 1);
+    }
+    clients_[slot].timer = timer;
+    clients_[slot].watch_index = watchers_[timer].size();
+    watchers_[timer].push_back(slot);
+  }
+
+  // Pushes what the client's outbox holds; false if the client must go
+  bool flush(std::size_t slot) {
+    Client& client = clients_[slot];
+    const FlushResult result = outbox_flush(client.output, client.fd);
+    if (result == FlushResult::kError) {
+      return false;
+    }
+    const bool want_write = result == FlushResult::kBlocked;
+    if (want_write != client.want_write) {
+      client.want_write = want_write;
+      return poller_.set_write(client.fd, kFirstClientTag + slot, want_write);
+    }
+    return true;
+  }
+
+  // Queues message on one client and writes what the socket will take;
+  // false if the client must go
+  bool send(std::size_t slot, const MessageRef& message) {
+    outbox_push(clients_[slot].output, message);
+    return flush(slot);
+  }
+
+  // Slots of the clients attached to timer
+  [[nodiscard]] std::span<const std::size_t> watchers(TimerId timer) const {
+    if (timer >= watchers_.size()) {
+      return {};
+    }
+    return watchers_[timer];
+  }
+
+  Client& operator[](std::size_t slot) { return clients_[slot]; }
+  [[nodiscard]] std::size_t slots() const { return clients_.size(); }
+
+ private:
+  // Swaps the last watcher into the client's place in the list
+  void detach(std::size_t slot) {
+    Client& client = clients_[slot];
+    if (client.timer == kNoTimer) {
+      return;
+    }
+    std::vector<std::size_t>& list = watchers_[client.timer];
+    const std::size_t moved = list.back();
+    list[client.watch_index] = moved;
+    clients_[moved].watch_index = client.watch_index;
+    list.pop_back();
+    client.timer = kNoTimer;
+  }
+
+  Poller& poller_;
+  std::vector<Client> clients_;
+  std::vector<std::size_t> free_;
+  std::vector<std::vector<std::size_t>> watchers_;
+};
+
+// A connection moving to the shard that owns the timer it attached to. The
+// client's receive buffer travels with it, so frames sent after kAttach are
+// handled by the new shard.
+struct Handoff {
+  Client client;
+  std::string timer;
+};
+
+// One event loop thread: the timers whose names hash to it, the clients
+// attached to them, and an inbox other shards hand connections over through
+struct Shard {
+  Shard(std::size_t shard_index, Clock::time_point start)
+      : index(shard_index), timers(start), clients(poller) {}
+
+  std::size_t index;
+  Poller poller;
+  Wakeup wakeup;
+  MpscQueue<Handoff> inbox;
+  TimerManager timers;
+  ClientTable clients;
+  // The daemon's checkpointed session and where status bars see it; only
+  // shard 0 has them
+  TimerId own = kNoTimer;
+  StatusPublisher status;
+  // Timers changed during this wakeup; may repeat
+  std::vector<TimerId> changed;
+};
+
+struct Daemon {
+  const DaemonConfig& config;
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+// The empty name (the daemon's own session) always lives on shard 0, where
+// new connections arrive
+std::size_t shard_of(const Daemon& daemon, std::string_view name) {
+  if (name.empty()) {
+    return 0;
+  }
+  return std::hash<std::string_view>{}(name) % daemon.shards.size();
+}
+
+// A named timer nobody is watching is forgotten once it holds nothing
+// worth keeping: stopped, or not yet started
+void release(Shard& shard, TimerId timer) {
+  if (timer != shard.own && shard.clients.watchers(timer).empty() &&
+      shard.timers.session(timer).status == SessionStatus::kStopped) {
+    shard.timers.remove(timer);
+  }
+}
+
+void drop_client(Shard& shard, std::size_t slot) {
+  const TimerId timer = shard.clients[slot].timer;
+  shard.clients.drop(slot);
+  release(shard, timer);
+}
+
+bool send_state(Shard& shard, std::size_t slot, Clock::time_point now) {
+  const TimerId timer = shard.clients[slot].timer;
+  return shard.clients.send(slot, message_make(session_event_make(
+                                      shard.timers.session(timer), now)));
+}
+
+// Sends message to every client attached to timer. Walks the list from
+// the back, since dropping a client swaps the last entry into its place.
+void broadcast(Shard& shard, TimerId timer, const MessageRef& message) {
+  for (std::size_t i = shard.clients.watchers(timer).size(); i > 0; --i) {
+    const std::size_t slot = shard.clients.watchers(timer)[i - 1];
+    if (!shard.clients.send(slot, message)) {
+      drop_client(shard, slot);
+    }
+  }
+}
+
+void hand_off(Daemon& daemon, Shard& shard, std::size_t slot,
+              std::string_view name) {
+  // Copied out first: name points into the client's buffer, which moves
+  std::string timer(name);
+  const TimerId previous = shard.clients[slot].timer;
+  Client client = shard.clients.take(slot);
+  release(shard, previous);
+  Shard& target = *daemon.shards[shard_of(daemon, timer)];
+  target.inbox.push({std::move(client), std::move(timer)});
+  target.wakeup.notify();
+}
+
+enum class FrameResult : std::uint8_t { kKeep, kDrop, kMoved };
+
+// Handles the complete frames in the client's buffer
+FrameResult handle_frames(Daemon& daemon, Shard& shard, std::size_t slot,
+                          Clock::time_point now) {
+  Client& client = shard.clients[slot];
+  Frame frame{};
+  while (client.input.next(frame)) {
+    std::string_view name;
+    switch (frame.type) {
+      case MessageType::kStartPause:
+      case MessageType::kReset:
+        shard.timers.apply(client.timer,
+                           frame.type == MessageType::kStartPause
+                               ? SessionCommand::kStartPause
+                               : SessionCommand::kReset,
+                           now);
+        shard.changed.push_back(client.timer);
+        break;
+      case MessageType::kAttach: {
+        if (!ipc_decode_attach(frame, name)) {
+          return FrameResult::kDrop;
+        }
+        if (shard_of(daemon, name) != shard.index) {
+          hand_off(daemon, shard, slot, name);
+          return FrameResult::kMoved;
+        }
+        const TimerId previous = client.timer;
+        shard.clients.attach(
+            slot, name.empty() ? shard.own
+                               : shard.timers.open(name,
+                                                   daemon.config.pomodoro,
+                                                   daemon.config.brk));
+        if (client.timer != previous) {
+          release(shard, previous);
+        }
+        if (!send_state(shard, slot, now)) {
+          return FrameResult::kDrop;
+        }
+        break;
+      }
+      case MessageType::kQuit:
+        return FrameResult::kDrop;
+      default:
+        // Not meant for the daemon, or newer than this version
+        break;
+    }
+  }
+  return client.input.malformed() ? FrameResult::kDrop : FrameResult::kKeep;
+}
+
+// Reads and handles everything the client sent
+FrameResult read_client(Daemon& daemon, Shard& shard, std::size_t slot,
+                        Clock::time_point now) {
+  while (true) {
+    const ReadResult result =
+        shard.clients[slot].input.fill(shard.clients[slot].fd);
+    const FrameResult handled = handle_frames(daemon, shard, slot, now);
+    if (handled != FrameResult::kKeep) {
+      return handled;
+    }
+    if (result == ReadResult::kClosed) {
+      return FrameResult::kDrop;
+    }
+    if (result == ReadResult::kDrained) {
+      return FrameResult::kKeep;
+    }
+  }
+}
+
+// Takes over a connection from another shard: attaches it, sends the
+// timer's state and handles the frames that came with it
+void adopt(Daemon& daemon, Shard& shard, Handoff handoff,
+           Clock::time_point now) {
+  const int fd = handoff.client.fd;
+  const TimerId timer =
+      handoff.timer.empty()
+          ? shard.own
+          : shard.timers.open(handoff.timer, daemon.config.pomodoro,
+                              daemon.config.brk);
+  const int added = shard.clients.add(std::move(handoff.client), timer);
+  if (added < 0) {
+    close(fd);
+    release(shard, timer);
+    return;
+  }
+  const auto slot = static_cast<std::size_t>(added);
+  if (!send_state(shard, slot, now) ||
+      handle_frames(daemon, shard, slot, now) == FrameResult::kDrop) {
+    drop_client(shard, slot);
+  }
+}
+
+// Every client holds a socket, so lift the soft descriptor limit as far as
+// the hard limit allows
+void raise_descriptor_limit() {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 &&
+      limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+// Checkpoints the daemon's own session and publishes it to status bars
+void save_own(const Daemon& daemon, Shard& shard, Clock::time_point now) {
+  if (shard.own == kNoTimer) {
+    return;
+  }
+  shard.status.publish(shard.timers.session(shard.own));
+  if (daemon.config.checkpoint_path.empty()) {
+    return;
+  }
+  checkpoint_save(daemon.config.checkpoint_path,
+                  checkpoint_make(shard.timers.pomodoro(shard.own),
+                                  shard.timers.brk(shard.own),
+                                  shard.timers.session(shard.own), now,
+                                  std::chrono::system_clock::now()));
+}
+
+// One shard's event loop, until a shutdown signal. Only shard 0 is given
+// the listening socket.
+void run_shard(Daemon& daemon, Shard& shard, int listen_fd, Clock& clock) {
+  while (shutdown_signal() == 0) {
+    // Sleep until a client speaks or drains, one connects or is handed
+    // over, or a phase ends
+    const auto events = shard.poller.wait(
+        poll_timeout_ms(shard.timers.next_deadline(), clock.now()));
+    const auto now = clock.now();
+
+    shard.changed.clear();
+    bool accept_pending = false;
+    bool inbox_pending = false;
+    for (const PollEvent& event : events) {
+      if (event.tag == kListenTag) {
+        accept_pending = true;
+        continue;
+      }
+      if (event.tag == kWakeupTag) {
+        inbox_pending = true;
+        continue;
+      }
+      if (event.tag == kShutdownTag) {
+        continue;
+      }
+      const std::size_t slot = event.tag - kFirstClientTag;
+      if (shard.clients[slot].fd < 0) {
+        continue;
+      }
+      FrameResult result = FrameResult::kKeep;
+      if (event.readable) {
+        result = read_client(daemon, shard, slot, now);
+      }
+      if (result == FrameResult::kKeep && event.writable &&
+          !shard.clients.flush(slot)) {
+        result = FrameResult::kDrop;
+      }
+      if (result == FrameResult::kDrop) {
+        drop_client(shard, slot);
+      }
+    }
+
+    if (inbox_pending) {
+      shard.wakeup.clear();
+      while (auto handoff = shard.inbox.pop()) {
+        adopt(daemon, shard, std::move(*handoff), now);
+      }
+    }
+
+    shard.timers.advance(now, shard.changed);
+
+    // Each changed timer's state is encoded once and shared by its clients
+    std::ranges::sort(shard.changed);
+    const auto repeats = std::ranges::unique(shard.changed);
+    shard.changed.erase(repeats.begin(), repeats.end());
+    for (const TimerId timer : shard.changed) {
+      if (timer == shard.own) {
+        save_own(daemon, shard, now);
+      }
+      broadcast(shard, timer,
+                message_make(
+                    session_event_make(shard.timers.session(timer), now)));
+    }
+
+    // New clients wait on the daemon's own timer until they attach
+    while (accept_pending) {
+      const int fd = ipc_accept(listen_fd);
+      if (fd < 0) {
+        break;
+      }
+      Client client;
+      client.fd = fd;
+      if (shard.clients.add(std::move(client), shard.own) < 0) {
+        close(fd);
+      }
+    }
+  }
+
+  save_own(daemon, shard, clock.now());
+  for (std::size_t slot = 0; slot < shard.clients.slots(); ++slot) {
+    if (shard.clients[slot].fd >= 0) {
+      shard.clients.drop(slot);
+    }
+  }
+}
+}  // namespace
+
+int daemon_run(const DaemonConfig& config, Clock& clock) {
+  raise_descriptor_limit();
+  std::string error;
+  const int listen_fd = ipc_listen(config.socket_path, error);
+  if (listen_fd < 0) {
+    std::fprintf(stderr, "pomodoro: %s\n", error.c_str());
+    return 1;
+  }
+
+  Daemon daemon{config, {}};
+  const std::size_t shard_count = std::max(config.shards, std::size_t{1});
+  for (std::size_t index = 0; index < shard_count; ++index) {
+    auto shard = std::make_unique<Shard>(index, clock.now());
+    if (!shard->poller.ok() || !shard->wakeup.ok() ||
+        !shard->poller.add(shutdown_fd(), kShutdownTag) ||
+        !shard->poller.add(shard->wakeup.fd(), kWakeupTag) ||
+        (index == 0 && !shard->poller.add(listen_fd, kListenTag))) {
+      std::fprintf(stderr, "pomodoro: cannot set up daemon event loops\n");
+      close(listen_fd);
+      ipc_unlink(config.socket_path);
+      return 1;
+    }
+    daemon.shards.push_back(std::move(shard));
+  }
+
+  Shard& first = *daemon.shards.front();
+  first.own = first.timers.open("", config.pomodoro, config.brk);
+  // A checkpointed session resumes with the lengths it was started with
+  if (Checkpoint checkpoint{};
+      !config.checkpoint_path.empty() &&
+      checkpoint_load(config.checkpoint_path, checkpoint)) {
+    first.timers.restore(first.own, {checkpoint.study}, {checkpoint.brk},
+                         checkpoint_restore(checkpoint, clock.now(),
+                                            std::chrono::system_clock::now()));
+  }
+  if (!config.status_path.empty()) {
+    if (!first.status.open(config.status_path, error)) {
+      std::fprintf(stderr, "pomodoro: %s\n", error.c_str());
+    }
+    first.status.publish(first.timers.session(first.own));
+  }
+
+  // Shard 0 runs on this thread; a shutdown signal ends every loop, since
+  // each one polls the same self-pipe
+  std::vector<std::thread> threads;
+  threads.reserve(shard_count - 1);
+  for (std::size_t index = 1; index < shard_count; ++index) {
+    threads.emplace_back(run_shard, std::ref(daemon),
+                         std::ref(*daemon.shards[index]), -1,
+                         std::ref(clock));
+  }
+  run_shard(daemon, first, listen_fd, clock);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Connections still in flight between shards
+  for (const auto& shard : daemon.shards) {
+    while (auto handoff = shard->inbox.pop()) {
+      close(handoff->client.fd);
+    }
+  }
+  close(listen_fd);
+  ipc_unlink(config.socket_path);
+  return kSignalExitBase + shutdown_signal();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "clock.h"
+#include "session.h"
+
+// Settings for the headless daemon (--daemon, or running as pomodorod)
+struct DaemonConfig {
+  std::string socket_path;
+  std::string checkpoint_path;
+  // Shared status file for status bars; empty disables it
+  std::string status_path;
+  SessionTime pomodoro;
+  SessionTime brk;
+  // Event loop threads; timers are spread over them by name
+  std::size_t shards;
+};
+
+// Runs the session engine without a terminal, serving TUI clients on the
+// socket until a shutdown signal arrives. Timers are sharded by name over
+// config.shards event loop threads, each with its own timers, timing wheel
+// and clients, so the loops share nothing. Connections arrive on shard 0
+// and are handed to the shard that owns the timer they attach to. Each
+// loop only wakes for client traffic and the end of a running phase;
+// clients are sent an event on attach and on every state change, and count
+// down between events on their own. Returns the process exit status.
+int daemon_run(const DaemonConfig& config, Clock& clock);
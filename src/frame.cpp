@@ -0,0 +1,71 @@
+#include "frame.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "timer.h"
+
+using namespace std::chrono;
+
+namespace {
+// Number of filled bar steps after elapsed out of total
+int bar_fill_for(steady_clock::duration elapsed, steady_clock::duration total,
+                 int bar_steps) {
+  if (total <= steady_clock::duration::zero()) {
+    return 0;
+  }
+  return static_cast<int>(std::min<steady_clock::rep>(
+      (elapsed.count() * bar_steps) / total.count(), bar_steps));
+}
+}  // namespace
+
+// Computes the clock-dependent part of the timer screen at now
+TimerView timer_view(const TimerTickState& state, Clock::time_point now,
+                     int bar_steps) {
+  const auto remaining = timer_remaining(state, now);
+  const steady_clock::duration total = state.total;
+  return {timer_remaining_seconds(state, now),
+          bar_fill_for(total - remaining, total, bar_steps)};
+}
+
+// Returns the earliest instant at which timer_view() changes: the next
+// displayed second or the next bar step, whichever comes first. Nothing
+// changes while the timer is not counting down.
+Clock::time_point next_frame_at(const TimerTickState& state,
+                                Clock::time_point now, int bar_steps) {
+  const auto next_second = timer_next_change(state, now);
+  if (next_second == Clock::time_point::max() || bar_steps <= 0) {
+    return next_second;
+  }
+  const steady_clock::duration total = state.total;
+  const auto remaining = timer_remaining(state, now);
+  const int fill = bar_fill_for(total - remaining, total, bar_steps);
+  if (fill >= bar_steps) {
+    return next_second;
+  }
+  // Smallest elapsed time at which the bar reaches fill + 1 steps
+  const steady_clock::duration next_elapsed(
+      ((fill + 1) * total.count() + bar_steps - 1) / bar_steps);
+  const auto next_step = state.deadline - (total - next_elapsed);
+  return std::min(next_second, next_step);
+}
+
+const char* format_duration(seconds value, DurationText& text) {
+  const auto hrs = duration_cast<hours>(value);
+  const auto mins = duration_cast<minutes>(value % hours(1));
+  const auto secs = value % minutes(1);
+  if (hrs.count() > 0) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::snprintf(text.data(), text.size(), "%lld:%02lld:%02lld",
+                  static_cast<long long>(hrs.count()),
+                  static_cast<long long>(mins.count()),
+                  static_cast<long long>(secs.count()));
+  } else {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    std::snprintf(text.data(), text.size(), "%02lld:%02lld",
+                  static_cast<long long>(mins.count()),
+                  static_cast<long long>(secs.count()));
+  }
+  return text.data();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "clock.h"
+#include "timer.h"
+
+// Everything on the timer screen that depends on the clock. Two views that
+// compare equal render identically, so a frame is only needed when it changes.
+// The bar is measured in steps (Layout::bar_steps), which are sub-cell
+// eighths on Unicode terminals.
+struct TimerView {
+  std::chrono::seconds display;
+  int bar_fill;
+
+  bool operator==(const TimerView&) const = default;
+};
+
+TimerView timer_view(const TimerTickState& state, Clock::time_point now,
+                     int bar_steps);
+Clock::time_point next_frame_at(const TimerTickState& state,
+                                Clock::time_point now, int bar_steps);
+
+// Room for the longest text format_duration() produces, with its NUL
+constexpr std::size_t kDurationTextLength = 32;
+using DurationText = std::array<char, kDurationTextLength>;
+
+// Formats a duration as MM:SS, switching to H:MM:SS from an hour on so long
+// sessions never show a truncated field; the one spelling of a time left
+// shared by the timer screen, the prompts and --status
+const char* format_duration(std::chrono::seconds value, DurationText& text);
@@ -0,0 +1,88 @@
+#include "fuzzy.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+// Offset of the first occurrence of letter (either case) in text at or after
+// from, or npos. memchr is vectorized by the C library, so the scan runs
+// many bytes per instruction; the second case is only searched up to the
+// first hit.
+std::size_t find_letter(std::string_view text, std::size_t from, char letter) {
+  if (from >= text.size()) {
+    return std::string_view::npos;
+  }
+  const auto byte = static_cast<unsigned char>(letter);
+  const int lower = std::tolower(byte);
+  const int upper = std::toupper(byte);
+  const char* begin = text.data() + from;
+  std::size_t length = text.size() - from;
+  const void* hit = std::memchr(begin, lower, length);
+  if (hit != nullptr) {
+    length = static_cast<std::size_t>(static_cast<const char*>(hit) - begin);
+  }
+  if (upper != lower && length > 0) {
+    if (const void* other = std::memchr(begin, upper, length)) {
+      hit = other;
+    }
+  }
+  if (hit == nullptr) {
+    return std::string_view::npos;
+  }
+  return from + static_cast<std::size_t>(static_cast<const char*>(hit) - begin);
+}
+}  // namespace
+
+// Starts with every option matching the empty query
+FuzzyFilter fuzzy_filter_make(std::size_t option_count) {
+  FuzzyFilter filter;
+  auto& all = filter.levels.emplace_back();
+  all.reserve(option_count);
+  for (std::size_t i = 0; i < option_count; ++i) {
+    all.push_back({static_cast<int>(i), 0});
+  }
+  return filter;
+}
+
+// Appends letter to the query, keeping only the current matches that can
+// extend their match with it. The new level reuses a dropped one's storage,
+// or else reserves for every current match surviving, so it is allocated at
+// most once.
+void fuzzy_filter_push(FuzzyFilter& filter,
+                       const std::vector<std::string>& options, char letter) {
+  const std::vector<FuzzyMatch>& current = filter.levels.back();
+  std::vector<FuzzyMatch> narrowed;
+  if (!filter.spare.empty()) {
+    narrowed = std::move(filter.spare.back());
+    filter.spare.pop_back();
+  }
+  narrowed.reserve(current.size());
+  for (const FuzzyMatch& match : current) {
+    const auto hit = find_letter(options[match.index], match.next, letter);
+    if (hit != std::string_view::npos) {
+      narrowed.push_back({match.index, hit + 1});
+    }
+  }
+  filter.query += letter;
+  filter.levels.push_back(std::move(narrowed));
+}
+
+// Removes the last query letter, restoring the previous candidate set
+void fuzzy_filter_pop(FuzzyFilter& filter) {
+  if (filter.query.empty()) {
+    return;
+  }
+  filter.query.pop_back();
+  filter.levels.back().clear();
+  filter.spare.push_back(std::move(filter.levels.back()));
+  filter.levels.pop_back();
+}
+
+const std::vector<FuzzyMatch>& fuzzy_filter_matches(const FuzzyFilter& filter) {
+  return filter.levels.back();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// An option that matches the query typed so far, plus the offset just past
+// the character that matched the query's last letter. Subsequence matching is
+// greedy, so extending the query only has to search from that offset.
+struct FuzzyMatch {
+  int index;
+  std::size_t next;
+};
+
+// Type-to-filter state of a menu. levels[n] holds the options matching the
+// first n query characters, so a new character narrows levels.back() and a
+// backspace just drops it; neither rescans the full option list. Dropped
+// levels are kept in spare, emptied but with their capacity, so typing again
+// after a backspace does not allocate.
+struct FuzzyFilter {
+  std::string query;
+  std::vector<std::vector<FuzzyMatch>> levels;
+  std::vector<std::vector<FuzzyMatch>> spare;
+};
+
+FuzzyFilter fuzzy_filter_make(std::size_t option_count);
+void fuzzy_filter_push(FuzzyFilter& filter,
+                       const std::vector<std::string>& options, char letter);
+void fuzzy_filter_pop(FuzzyFilter& filter);
+const std::vector<FuzzyMatch>& fuzzy_filter_matches(const FuzzyFilter& filter);
@@ -0,0 +1,94 @@
+#include "headless_renderer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "utf8.h"
+
+namespace {
+constexpr char kReverseMark = '^';
+// Longest UTF-8 encoding of one cell
+constexpr std::size_t kMaxCellBytes = 4;
+
+template <typename Char>
+std::basic_string_view<Char> trim_right(std::basic_string_view<Char> row) {
+  const auto end = row.find_last_not_of(Char(' '));
+  return end == std::basic_string_view<Char>::npos ? row.substr(0, 0)
+                                                    : row.substr(0, end + 1);
+}
+}  // namespace
+
+void NullRenderer::put(int /*row*/, int /*col*/, std::string_view text,
+                       Attr /*attr*/) {
+  stats_.cells += utf8_length(text);
+}
+
+void NullRenderer::flush() { ++stats_.frames; }
+
+RecordingRenderer::RecordingRenderer(const std::string& path, int input)
+    : input_(input) {
+  clear();
+  if (!path.empty()) {
+    out_.open(path, std::ios::out | std::ios::trunc);
+    line_.reserve(static_cast<std::size_t>(kHeadlessSize.cols) * kMaxCellBytes);
+  }
+}
+
+// Decodes the run into the grid, clipping at the right edge
+void RecordingRenderer::put(int row, int col, std::string_view text,
+                            Attr attr) {
+  if (row < 0 || row >= kHeadlessSize.rows || col < 0 ||
+      col >= kHeadlessSize.cols) {
+    return;
+  }
+  const char mark = attr == Attr::kReverse ? kReverseMark : ' ';
+  auto cell = static_cast<std::size_t>(col);
+  while (!text.empty() && cell < static_cast<std::size_t>(kHeadlessSize.cols)) {
+    grid_.rows[row][cell] = utf8_pop(text);
+    grid_.reverse[row][cell] = mark;
+    ++cell;
+    ++stats_.cells;
+  }
+}
+
+void RecordingRenderer::flush() {
+  ++stats_.frames;
+  if (out_.is_open()) {
+    write_frame(grid_);
+    return;
+  }
+  frames_.push_back(grid_);
+}
+
+void RecordingRenderer::clear() {
+  const auto cols = static_cast<std::size_t>(kHeadlessSize.cols);
+  grid_.rows.assign(kHeadlessSize.rows, std::u32string(cols, U' '));
+  grid_.reverse.assign(kHeadlessSize.rows, std::string(cols, ' '));
+}
+
+// Appends a frame as "| " text lines, each followed by a "^ " line when the
+// row contains reverse-video cells; trailing blanks are trimmed so snapshots
+// diff cleanly
+void RecordingRenderer::write_frame(const RecordedFrame& frame) {
+  out_ << "=== frame " << stats_.frames << " ===\n";
+  std::size_t last_row = frame.rows.size();
+  while (last_row > 0 &&
+         trim_right<char32_t>(frame.rows[last_row - 1]).empty() &&
+         trim_right<char>(frame.reverse[last_row - 1]).empty()) {
+    --last_row;
+  }
+  for (std::size_t row = 0; row < last_row; ++row) {
+    line_.clear();
+    for (const char32_t cell : trim_right<char32_t>(frame.rows[row])) {
+      utf8_append(line_, cell);
+    }
+    out_ << "| " << line_ << '\n';
+    const auto marks = trim_right<char>(frame.reverse[row]);
+    if (!marks.empty()) {
+      out_ << "^ " << marks << '\n';
+    }
+  }
+  out_.flush();
+}
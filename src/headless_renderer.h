@@ -0,0 +1,80 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "renderer.h"
+#include "tty_input.h"
+
+// Size reported by the headless backends, which have no terminal to query
+constexpr TermSize kHeadlessSize{24, 80};
+
+// Discards all output and only counts it, so the cost of producing frames can
+// be measured without a terminal. Keys come from stdin (or input) through
+// TtyInput, so a run can be scripted by piping keystrokes in.
+class NullRenderer final : public Renderer {
+ public:
+  explicit NullRenderer(int input = STDIN_FILENO) : input_(input) {}
+
+  [[nodiscard]] TermSize size() const override { return kHeadlessSize; }
+  void put(int row, int col, std::string_view text, Attr attr) override;
+  void flush() override;
+  void clear() override {}
+  int read_key(bool block) override { return input_.read_key(block); }
+  [[nodiscard]] int input_fd() const override { return input_.fd(); }
+  [[nodiscard]] bool unicode() const override { return true; }
+  [[nodiscard]] const OutputStats* output_stats() const override {
+    return &stats_;
+  }
+
+ private:
+  TtyInput input_;
+  OutputStats stats_{};
+};
+
+// One captured frame: the character grid (one code point per cell) plus, per
+// row, '^' under every reverse-video cell and ' ' elsewhere
+struct RecordedFrame {
+  std::vector<std::u32string> rows;
+  std::vector<std::string> reverse;
+};
+
+// Applies output to an in-memory grid and captures a copy of it on every
+// flush, for golden snapshots. When given a path, each frame is appended to
+// that file instead of being kept, so a long recording runs in constant
+// memory and without allocating per frame; frames() then stays empty.
+class RecordingRenderer final : public Renderer {
+ public:
+  explicit RecordingRenderer(const std::string& path = {},
+                             int input = STDIN_FILENO);
+
+  [[nodiscard]] TermSize size() const override { return kHeadlessSize; }
+  void put(int row, int col, std::string_view text, Attr attr) override;
+  void flush() override;
+  void clear() override;
+  int read_key(bool block) override { return input_.read_key(block); }
+  [[nodiscard]] int input_fd() const override { return input_.fd(); }
+  [[nodiscard]] bool unicode() const override { return true; }
+  [[nodiscard]] const OutputStats* output_stats() const override {
+    return &stats_;
+  }
+
+  [[nodiscard]] const std::vector<RecordedFrame>& frames() const {
+    return frames_;
+  }
+
+ private:
+  void write_frame(const RecordedFrame& frame);
+
+  TtyInput input_;
+  RecordedFrame grid_;
+  std::vector<RecordedFrame> frames_;
+  std::ofstream out_;
+  // UTF-8 encoding of the row being written out; reused across frames
+  std::string line_;
+  OutputStats stats_{};
+};
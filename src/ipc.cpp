@@ -0,0 +1,321 @@
+#include "ipc.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "timer.h"
+
+using namespace std::chrono;
+
+namespace {
+constexpr int kListenBacklog = 128;
+// kState payload: u8 on_break, u8 status, u8 counting, u8 zero,
+// u64 total seconds, u64 remaining milliseconds
+constexpr std::size_t kStatePayloadLength = 20;
+
+void put_u16(std::span<std::uint8_t> out, std::uint16_t value) {
+  out[0] = static_cast<std::uint8_t>(value);
+  out[1] = static_cast<std::uint8_t>(value >> 8U);
+}
+
+void put_u64(std::span<std::uint8_t> out, std::uint64_t value) {
+  for (std::size_t i = 0; i < sizeof(value); ++i) {
+    out[i] = static_cast<std::uint8_t>(value >> (8U * i));
+  }
+}
+
+std::uint64_t get_u64(std::span<const std::uint8_t> in) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < sizeof(value); ++i) {
+    value |= static_cast<std::uint64_t>(in[i]) << (8U * i);
+  }
+  return value;
+}
+
+// Writes the header of a frame with a payload of length bytes; false if the
+// whole frame does not fit in out
+bool begin_frame(std::span<std::uint8_t> out, MessageType type,
+                 std::size_t length) {
+  if (kFrameHeaderLength + length > out.size()) {
+    return false;
+  }
+  out[0] = kProtocolVersion;
+  out[1] = static_cast<std::uint8_t>(type);
+  put_u16(out.subspan(2), static_cast<std::uint16_t>(length));
+  return true;
+}
+
+bool make_address(const std::string& path, sockaddr_un& address) {
+  address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+int make_socket() {
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return fd;
+}
+
+void set_nonblocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+// sockaddr_un is passed through the generic sockaddr interface
+const sockaddr* as_sockaddr(const sockaddr_un& address) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) // sockets API
+  return reinterpret_cast<const sockaddr*>(&address);
+}
+}  // namespace
+
+SessionEvent session_event_make(const SessionState& session,
+                                Clock::time_point now) {
+  return {session.on_break, session.status, session.tick.total,
+          session.tick.counting,
+          ceil<milliseconds>(timer_remaining(session.tick, now))};
+}
+
+// Anchors the received time left to the local clock
+SessionState session_event_state(const SessionEvent& event,
+                                 Clock::time_point now) {
+  SessionState session{event.on_break, timer_make(event.total), event.status};
+  session.tick.remaining = std::min<steady_clock::duration>(
+      event.remaining, session.tick.total);
+  if (event.counting) {
+    timer_start(session.tick, now);
+  }
+  return session;
+}
+
+std::size_t ipc_encode_event(const SessionEvent& event,
+                             std::span<std::uint8_t> out) {
+  if (!begin_frame(out, MessageType::kState, kStatePayloadLength)) {
+    return 0;
+  }
+  const auto payload = out.subspan(kFrameHeaderLength, kStatePayloadLength);
+  payload[0] = event.on_break ? 1 : 0;
+  payload[1] = static_cast<std::uint8_t>(event.status);
+  payload[2] = event.counting ? 1 : 0;
+  payload[3] = 0;
+  put_u64(payload.subspan(4), static_cast<std::uint64_t>(event.total.count()));
+  put_u64(payload.subspan(12),
+          static_cast<std::uint64_t>(event.remaining.count()));
+  return kFrameHeaderLength + kStatePayloadLength;
+}
+
+std::size_t ipc_encode_command(MessageType command,
+                               std::span<std::uint8_t> out) {
+  return begin_frame(out, command, 0) ? kFrameHeaderLength : 0;
+}
+
+std::size_t ipc_encode_attach(std::string_view name,
+                              std::span<std::uint8_t> out) {
+  if (name.size() > kMaxTimerNameLength ||
+      !begin_frame(out, MessageType::kAttach, name.size())) {
+    return 0;
+  }
+  std::ranges::copy(name, out.begin() + kFrameHeaderLength);
+  return kFrameHeaderLength + name.size();
+}
+
+bool ipc_decode_event(const Frame& frame, SessionEvent& event) {
+  if (frame.type != MessageType::kState ||
+      frame.payload.size() != kStatePayloadLength) {
+    return false;
+  }
+  const auto payload = frame.payload;
+  const std::uint64_t total = get_u64(payload.subspan(4));
+  const std::uint64_t remaining = get_u64(payload.subspan(12));
+  // Bounded so the values stay positive as signed 64-bit durations
+  constexpr std::uint64_t kMaxCount = std::uint64_t{1} << 62U;
+  if (payload[1] >= kSessionStatusText.size() || total == 0 ||
+      total >= kMaxCount || remaining >= kMaxCount) {
+    return false;
+  }
+  event = {payload[0] != 0, static_cast<SessionStatus>(payload[1]),
+           seconds(static_cast<seconds::rep>(total)), payload[2] != 0,
+           milliseconds(static_cast<milliseconds::rep>(remaining))};
+  return true;
+}
+
+bool ipc_decode_attach(const Frame& frame, std::string_view& name) {
+  if (frame.type != MessageType::kAttach ||
+      frame.payload.size() > kMaxTimerNameLength) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) // byte view
+  name = std::string_view(reinterpret_cast<const char*>(frame.payload.data()),
+                          frame.payload.size());
+  return true;
+}
+
+std::string ipc_default_socket_path() {
+  if (const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+      runtime != nullptr && *runtime != '\0') {
+    return std::string(runtime) + "/pomodoro.sock";
+  }
+  return "/tmp/pomodoro-" + std::to_string(getuid()) + ".sock";
+}
+
+// A path that still accepts connections belongs to a live daemon and is left
+// alone; a socket nobody accepts on is a leftover and is removed, and
+// anything that is not a socket is refused rather than deleted
+int ipc_listen(const std::string& path, std::string& error) {
+  sockaddr_un address{};
+  if (!make_address(path, address)) {
+    error = "socket path too long: " + path;
+    return -1;
+  }
+  if (const int probe = ipc_connect(path); probe >= 0) {
+    close(probe);
+    error = "a daemon is already listening on " + path;
+    return -1;
+  }
+  if (struct stat info{}; lstat(path.c_str(), &info) == 0) {
+    if (!S_ISSOCK(info.st_mode)) {
+      error = "not a socket, refusing to replace it: " + path;
+      return -1;
+    }
+    unlink(path.c_str());
+  }
+  const int fd = make_socket();
+  if (fd < 0 || bind(fd, as_sockaddr(address), sizeof(address)) != 0 ||
+      listen(fd, kListenBacklog) != 0) {
+    error = "cannot listen on " + path + ": " + std::strerror(errno);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+  set_nonblocking(fd);
+  return fd;
+}
+
+void ipc_unlink(const std::string& path) {
+  if (struct stat info{};
+      lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+    unlink(path.c_str());
+  }
+}
+
+int ipc_accept(int listen_fd) {
+  const int fd = accept(listen_fd, nullptr, nullptr);
+  if (fd >= 0) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    set_nonblocking(fd);
+  }
+  return fd;
+}
+
+int ipc_connect(const std::string& path) {
+  sockaddr_un address{};
+  if (!make_address(path, address)) {
+    return -1;
+  }
+  const int fd = make_socket();
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, as_sockaddr(address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  set_nonblocking(fd);
+  return fd;
+}
+
+bool ipc_send(int fd, std::span<const std::uint8_t> bytes) {
+  while (!bytes.empty()) {
+    const ssize_t written = write(fd, bytes.data(), bytes.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    bytes = bytes.subspan(static_cast<std::size_t>(written));
+  }
+  return true;
+}
+
+std::ptrdiff_t ipc_write_some(int fd, std::span<const std::uint8_t> bytes) {
+  while (true) {
+    const ssize_t written = write(fd, bytes.data(), bytes.size());
+    if (written >= 0) {
+      return written;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return 0;
+    }
+    if (errno != EINTR) {
+      return -1;
+    }
+  }
+}
+
+// Consumed frames are dropped first; what remains is at most a partial
+// frame, so the move is a few bytes
+ReadResult FrameBuffer::fill(int fd) {
+  if (begin_ > 0) {
+    std::memmove(data_.data(), data_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  while (end_ < data_.size()) {
+    const ssize_t count = read(fd, data_.data() + end_, data_.size() - end_);
+    if (count > 0) {
+      end_ += static_cast<std::size_t>(count);
+      continue;
+    }
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return ReadResult::kDrained;
+    }
+    return ReadResult::kClosed;
+  }
+  return ReadResult::kFull;
+}
+
+bool FrameBuffer::next(Frame& frame) {
+  if (malformed_ || end_ - begin_ < kFrameHeaderLength) {
+    return false;
+  }
+  const std::span<const std::uint8_t> pending(data_.data() + begin_,
+                                              end_ - begin_);
+  const std::size_t length =
+      kFrameHeaderLength +
+      static_cast<std::size_t>(pending[2] | (pending[3] << 8U));
+  if (pending[0] != kProtocolVersion || length > kMaxMessageLength) {
+    malformed_ = true;
+    return false;
+  }
+  if (pending.size() < length) {
+    return false;
+  }
+  frame = {static_cast<MessageType>(pending[1]),
+           pending.subspan(kFrameHeaderLength,
+                           length - kFrameHeaderLength)};
+  begin_ += length;
+  return true;
+}
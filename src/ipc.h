@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "clock.h"
+#include "session.h"
+#include "timer_manager.h"
+
+// Unix domain socket plumbing shared by the daemon and the TUI client, and
+// the binary protocol they speak. Every message is a frame:
+//   u8 version | u8 type | u16 payload length | payload
+// with integers little-endian. A client opens with kAttach naming the timer
+// it wants (empty for the daemon's own session) and is sent its kState, then
+// another after every change to it. Clients send kStartPause and kReset (the
+// s and r keys) and kQuit (q) before hanging up. A frame from another
+// protocol version is an error; an unknown type within this version is
+// skipped, so messages can be added without breaking older peers.
+// Events carry the time left rather than a deadline, so each side keeps its
+// own steady clock and the countdown needs no traffic between changes.
+
+inline constexpr std::uint8_t kProtocolVersion = 1;
+
+enum class MessageType : std::uint8_t {
+  kState = 1,
+  kStartPause = 2,
+  kReset = 3,
+  kQuit = 4,
+  kAttach = 5,
+};
+
+inline constexpr std::size_t kFrameHeaderLength = 4;
+// Longest frame this version sends; longer ones are a protocol error
+inline constexpr std::size_t kMaxMessageLength = 64;
+
+// A received frame. The payload points into the FrameBuffer that produced
+// it and is valid until its next fill().
+struct Frame {
+  MessageType type;
+  std::span<const std::uint8_t> payload;
+};
+
+// One session state change as sent to clients
+struct SessionEvent {
+  bool on_break;
+  SessionStatus status;
+  std::chrono::seconds total;
+  bool counting;
+  std::chrono::milliseconds remaining;
+};
+
+SessionEvent session_event_make(const SessionState& session,
+                                Clock::time_point now);
+SessionState session_event_state(const SessionEvent& event,
+                                 Clock::time_point now);
+
+// Encode a frame into out and return its length, or 0 if it does not fit
+std::size_t ipc_encode_event(const SessionEvent& event,
+                             std::span<std::uint8_t> out);
+// For the payload-free client messages (kStartPause, kReset, kQuit)
+std::size_t ipc_encode_command(MessageType command,
+                               std::span<std::uint8_t> out);
+// kAttach carrying the timer name, at most kMaxTimerNameLength bytes
+std::size_t ipc_encode_attach(std::string_view name,
+                              std::span<std::uint8_t> out);
+// Reads a kState payload in place
+bool ipc_decode_event(const Frame& frame, SessionEvent& event);
+// Views the name in a kAttach payload, without copying it out
+bool ipc_decode_attach(const Frame& frame, std::string_view& name);
+
+// $XDG_RUNTIME_DIR/pomodoro.sock, falling back to /tmp/pomodoro-<uid>.sock
+std::string ipc_default_socket_path();
+// Binds and listens on path, replacing a stale socket left by a dead daemon.
+// Returns the non-blocking listening descriptor, or -1 with error set; a
+// path that exists but is not a socket is an error, never removed.
+int ipc_listen(const std::string& path, std::string& error);
+// Removes the socket at path on shutdown; leaves anything else alone
+void ipc_unlink(const std::string& path);
+// Accepts a pending connection; returns a non-blocking descriptor or -1
+int ipc_accept(int listen_fd);
+// Connects to the daemon at path; returns a non-blocking descriptor or -1
+int ipc_connect(const std::string& path);
+// Writes all of bytes to a socket; false if the peer cannot take them now
+bool ipc_send(int fd, std::span<const std::uint8_t> bytes);
+// Writes what the socket will take without blocking; returns the count
+// written (0 when it is full) or -1 on error
+std::ptrdiff_t ipc_write_some(int fd, std::span<const std::uint8_t> bytes);
+
+enum class ReadResult : std::uint8_t { kDrained, kFull, kClosed };
+
+// Receive buffer for one stream socket. Frames are handed out as views into
+// the buffer, so nothing is copied between the read() and the decoder; only
+// a trailing partial frame is moved to the front when space runs out.
+class FrameBuffer {
+ public:
+  // Reads until the socket is drained (kDrained), the buffer is full
+  // (kFull: take the frames, then fill again) or the peer is gone (kClosed)
+  ReadResult fill(int fd);
+  // Takes the next complete frame, if any
+  bool next(Frame& frame);
+  // True once a frame with another version or an oversized length arrived
+  [[nodiscard]] bool malformed() const { return malformed_; }
+
+ private:
+  static constexpr std::size_t kCapacity = 1024;
+
+  std::array<std::uint8_t, kCapacity> data_{};
+  std::size_t begin_ = 0;
+  std::size_t end_ = 0;
+  bool malformed_ = false;
+};
@@ -0,0 +1,210 @@
+#include "keymap.h"
+
+#include <ncurses.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+static_assert(KEY_MAX + 1 == kKeyTableSize);
+
+namespace {
+constexpr int kEnterKey = 10;
+constexpr int kReturnKey = 13;
+constexpr int kDeleteKey = 127;
+constexpr int kBackspaceKey = 8;
+constexpr int kTabKey = 9;
+constexpr int kEscapeKey = 27;
+constexpr int kSpaceKey = 32;
+
+struct Binding {
+  int key;
+  Action action;
+};
+
+constexpr KeyTable make_table(std::initializer_list<Binding> bindings) {
+  KeyTable table{};
+  for (const Binding& binding : bindings) {
+    table.at(static_cast<std::size_t>(binding.key)) = binding.action;
+  }
+  return table;
+}
+
+// Default bindings, shared keys mean the same thing on every screen. Menus
+// leave letters unbound so they type into the filter.
+constexpr std::array<KeyTable, kKeyContextCount> kDefaultTables = {
+    // KeyContext::kTimer
+    make_table({{'q', Action::kQuit},
+                {'Q', Action::kQuit},
+                {KEY_EXIT, Action::kQuit},
+                {'s', Action::kStartPause},
+                {'r', Action::kReset},
+                {KEY_RESIZE, Action::kResize}}),
+    // KeyContext::kMenu
+    make_table({{KEY_EXIT, Action::kQuit},
+                {KEY_UP, Action::kUp},
+                {KEY_DOWN, Action::kDown},
+                {KEY_PPAGE, Action::kPageUp},
+                {KEY_NPAGE, Action::kPageDown},
+                {KEY_HOME, Action::kHome},
+                {KEY_END, Action::kEnd},
+                {kEnterKey, Action::kConfirm},
+                {kReturnKey, Action::kConfirm},
+                {KEY_ENTER, Action::kConfirm},
+                {KEY_BACKSPACE, Action::kErase},
+                {kDeleteKey, Action::kErase},
+                {kBackspaceKey, Action::kErase},
+                {KEY_RESIZE, Action::kResize}}),
+    // KeyContext::kPrompt
+    make_table({{'q', Action::kQuit},
+                {'Q', Action::kQuit},
+                {KEY_EXIT, Action::kQuit},
+                {KEY_RESIZE, Action::kResize}}),
+};
+
+struct Name {
+  std::string_view name;
+  int value;
+};
+
+constexpr std::array<Name, 3> kContextNames = {{
+    {"timer", static_cast<int>(KeyContext::kTimer)},
+    {"menu", static_cast<int>(KeyContext::kMenu)},
+    {"prompt", static_cast<int>(KeyContext::kPrompt)},
+}};
+
+constexpr std::array<Name, 12> kActionNames = {{
+    {"none", static_cast<int>(Action::kNone)},
+    {"quit", static_cast<int>(Action::kQuit)},
+    {"start_pause", static_cast<int>(Action::kStartPause)},
+    {"reset", static_cast<int>(Action::kReset)},
+    {"up", static_cast<int>(Action::kUp)},
+    {"down", static_cast<int>(Action::kDown)},
+    {"page_up", static_cast<int>(Action::kPageUp)},
+    {"page_down", static_cast<int>(Action::kPageDown)},
+    {"home", static_cast<int>(Action::kHome)},
+    {"end", static_cast<int>(Action::kEnd)},
+    {"confirm", static_cast<int>(Action::kConfirm)},
+    {"erase", static_cast<int>(Action::kErase)},
+}};
+
+constexpr std::array<Name, 13> kKeyNames = {{
+    {"space", kSpaceKey},
+    {"enter", kEnterKey},
+    {"tab", kTabKey},
+    {"esc", kEscapeKey},
+    {"backspace", KEY_BACKSPACE},
+    {"up", KEY_UP},
+    {"down", KEY_DOWN},
+    {"left", KEY_LEFT},
+    {"right", KEY_RIGHT},
+    {"pgup", KEY_PPAGE},
+    {"pgdn", KEY_NPAGE},
+    {"home", KEY_HOME},
+    {"end", KEY_END},
+}};
+
+// Returns the value named by name, or -1
+template <std::size_t N>
+int find_name(const std::array<Name, N>& names, std::string_view name) {
+  for (const Name& entry : names) {
+    if (entry.name == name) {
+      return entry.value;
+    }
+  }
+  return -1;
+}
+
+// A single printable character names itself; anything longer must be one of
+// kKeyNames
+int parse_key(std::string_view name) {
+  if (name.size() == 1 && name.front() > kSpaceKey &&
+      name.front() < kDeleteKey) {
+    return name.front();
+  }
+  return find_name(kKeyNames, name);
+}
+
+// Space through '~' type into a menu's filter, so a menu binding for one of
+// them would make that character impossible to search for
+bool types_into_filter(int key) { return key >= kSpaceKey && key < kDeleteKey; }
+}  // namespace
+
+Keymap keymap_defaults() { return {kDefaultTables}; }
+
+std::string keymap_config_path() {
+  if (const char* config = std::getenv("XDG_CONFIG_HOME");
+      config != nullptr && *config != '\0') {
+    return std::string(config) + "/pomodoro/keys.conf";
+  }
+  if (const char* home = std::getenv("HOME");
+      home != nullptr && *home != '\0') {
+    return std::string(home) + "/.config/pomodoro/keys.conf";
+  }
+  return {};
+}
+
+// Each non-blank line not starting with '#' reads "<screen> <key> <action>",
+// where screen is timer, menu, prompt or all. Menus keep their typing keys:
+// binding one on the menu is an error, and "all" leaves the menu out.
+bool keymap_load(Keymap& keymap, const std::string& path, std::string& error) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    return true;
+  }
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    std::istringstream fields(line);
+    std::string screen_name;
+    std::string key_name;
+    std::string action_name;
+    std::string extra;
+    if (!(fields >> screen_name) || screen_name.front() == '#') {
+      continue;
+    }
+    const std::string where = path + ":" + std::to_string(line_number) + ": ";
+    if (!(fields >> key_name >> action_name) || (fields >> extra)) {
+      error = where + "expected '<screen> <key> <action>'";
+      return false;
+    }
+    const int context = find_name(kContextNames, screen_name);
+    if (context < 0 && screen_name != "all") {
+      error = where + "unknown screen '" + screen_name + "'";
+      return false;
+    }
+    const int key = parse_key(key_name);
+    if (key < 0) {
+      error = where + "unknown key '" + key_name + "'";
+      return false;
+    }
+    const int action = find_name(kActionNames, action_name);
+    if (action < 0) {
+      error = where + "unknown action '" + action_name + "'";
+      return false;
+    }
+    constexpr auto kMenu = static_cast<int>(KeyContext::kMenu);
+    const bool typed = types_into_filter(key) &&
+                       static_cast<Action>(action) != Action::kNone;
+    if (typed && context == kMenu) {
+      error = where + "'" + key_name + "' types into the menu filter";
+      return false;
+    }
+    for (std::size_t index = 0; index < kKeyContextCount; ++index) {
+      const bool applies =
+          context < 0 ? !(typed && index == static_cast<std::size_t>(kMenu))
+                      : static_cast<std::size_t>(context) == index;
+      if (applies) {
+        keymap.tables.at(index).at(static_cast<std::size_t>(key)) =
+            static_cast<Action>(action);
+      }
+    }
+  }
+  return true;
+}
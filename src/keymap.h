@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// What a key does. Keys bound to kNone fall through to the screen's default
+// handling (typing into a menu filter, "any key" on a prompt).
+enum class Action : std::uint8_t {
+  kNone,
+  kQuit,
+  kStartPause,
+  kReset,
+  kUp,
+  kDown,
+  kPageUp,
+  kPageDown,
+  kHome,
+  kEnd,
+  kConfirm,
+  kErase,
+  kResize,
+};
+
+// Screens with their own bindings
+enum class KeyContext : std::uint8_t { kTimer, kMenu, kPrompt };
+inline constexpr std::size_t kKeyContextCount = 3;
+
+// One slot per curses key code (KEY_MAX + 1, checked in keymap.cpp), so a
+// lookup is a bounds check and one indexed load
+inline constexpr std::size_t kKeyTableSize = 512;
+using KeyTable = std::array<Action, kKeyTableSize>;
+
+// Bindings for every screen. Defaults are built at compile time; a config
+// file can override individual entries at startup.
+struct Keymap {
+  std::array<KeyTable, kKeyContextCount> tables;
+};
+
+Keymap keymap_defaults();
+// Path of the user's binding file: $XDG_CONFIG_HOME/pomodoro/keys.conf,
+// falling back to ~/.config/pomodoro/keys.conf
+std::string keymap_config_path();
+// Applies the bindings in path on top of keymap. A missing file is not an
+// error; a malformed line is reported through error as "path:line: reason".
+bool keymap_load(Keymap& keymap, const std::string& path, std::string& error);
+
+inline Action keymap_lookup(const Keymap& keymap, KeyContext context,
+                            int key) {
+  const auto index = static_cast<std::size_t>(static_cast<unsigned>(key));
+  if (index >= kKeyTableSize) {
+    return Action::kNone;
+  }
+  return keymap.tables[static_cast<std::size_t>(context)][index];
+}
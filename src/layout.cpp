@@ -0,0 +1,56 @@
+#include "layout.h"
+
+#include <algorithm>
+
+namespace {
+constexpr int kMargin = 2;
+constexpr int kIndent = 4;
+// Rows needed for the spaced-out timer screen (status line included)
+constexpr int kSpaciousRows = 8;
+constexpr int kMinBarWidth = 10;
+constexpr int kMaxBarWidth = 120;
+// Eighth blocks U+2589..U+258F split a cell into eight steps
+constexpr int kEighthsPerCell = 8;
+}  // namespace
+
+// Uses the original spaced-out rows when they fit and packs everything
+// against the top otherwise; the bar stretches to the available width and
+// moves in eighths of a cell when the terminal can draw block glyphs
+Layout compute_layout(TermSize size, bool unicode) {
+  Layout layout{};
+  layout.margin = kMargin;
+  layout.indent = kIndent;
+  // Brackets take one column each
+  layout.bar_width =
+      std::clamp(size.cols - (2 * kMargin) - 2, kMinBarWidth, kMaxBarWidth);
+  layout.bar_resolution = unicode ? kEighthsPerCell : 1;
+  layout.bar_steps = layout.bar_width * layout.bar_resolution;
+  if (size.rows >= kSpaciousRows) {
+    layout.title_row = 1;
+    layout.time_row = 3;
+    layout.bar_row = 4;
+    layout.control_row = 5;
+    layout.status_row = 7;
+    layout.stats_row = 9;
+    layout.prompt_row = 3;
+    layout.prompt_detail_row = 5;
+    layout.prompt_help_row = 7;
+    layout.menu_prompt_row = 1;
+    layout.menu_first_row = 3;
+  } else {
+    layout.title_row = 0;
+    layout.time_row = 1;
+    layout.bar_row = 2;
+    layout.control_row = 3;
+    layout.status_row = 4;
+    layout.stats_row = 5;
+    layout.prompt_row = 0;
+    layout.prompt_detail_row = 1;
+    layout.prompt_help_row = 2;
+    layout.menu_prompt_row = 0;
+    layout.menu_first_row = 1;
+  }
+  // Leave the last row for the menu's help line
+  layout.menu_rows = std::max(1, size.rows - layout.menu_first_row - 1);
+  return layout;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "renderer.h"
+
+// Positions of every UI element for one terminal size. Computed once per
+// resize and cached by Screen, so draw calls only read fields.
+struct Layout {
+  int margin;
+  int indent;
+  int title_row;
+  int time_row;
+  int bar_row;
+  int control_row;
+  int status_row;
+  int stats_row;
+  int bar_width;
+  // Distinct fill levels per bar cell: 8 with Unicode eighth blocks, 1 when
+  // the terminal only gets whole ASCII cells
+  int bar_resolution;
+  // bar_width * bar_resolution, the unit TimerView::bar_fill is counted in
+  int bar_steps;
+  int prompt_row;
+  int prompt_detail_row;
+  int prompt_help_row;
+  int menu_prompt_row;
+  int menu_first_row;
+  int menu_rows;
+};
+
+Layout compute_layout(TermSize size, bool unicode);
@@ -1,36 +1,51 @@
-#include <ncurses.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <clocale>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "checkpoint.h"
+#include "client.h"
+#include "clock.h"
+#include "daemon.h"
+#include "frame.h"
+#include "ipc.h"
+#include "keymap.h"
 #include "pomodoro.h"
+#include "renderer.h"
+#include "screen.h"
+#include "shutdown.h"
+#include "status_file.h"
 
-int main(int argc, char* argv[]) {
-  initscr();
-  cbreak();
-  noecho();
-  nodelay(stdscr, FALSE);
-  keypad(stdscr, TRUE);
+using namespace std::chrono_literals;
 
-  // Check for debug flag
-  bool debug_mode = false;
-  for (int arg_index = 1; arg_index < argc; ++arg_index) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
-    // Standard C++ argv usage
-    if (std::string(argv[arg_index]) == "--debug") {
-      debug_mode = true;
-      break;
-    }
-  }
+namespace {
+// Upper bound for --shards
+constexpr std::size_t kMaxShards = 64;
+// Longest a --status --follow reader goes without looking at the file
+constexpr Clock::duration kFollowInterval = 250ms;
 
+// Asks for the study and break lengths; returns false if the user quits
+bool choose_sessions(Screen& screen, bool debug_mode, SessionTime& pomodoro,
+                     SessionTime& brk) {
   // Menu options for study and break durations using struct-based vectors
-  std::vector<TimerOption> study_options = {{"25:00 (Short Study)", 25, 0},
-                                            {"50:00 (Long Study)", 50, 0}};
-  std::vector<TimerOption> break_options = {{"5:00 (Short Break)", 5, 0},
-                                            {"10:00 (Long Break)", 10, 0}};
+  std::vector<TimerOption> study_options = {{"25:00 (Short Study)", 25min},
+                                            {"50:00 (Long Study)", 50min}};
+  std::vector<TimerOption> break_options = {{"5:00 (Short Break)", 5min},
+                                            {"10:00 (Long Break)", 10min}};
   if (debug_mode) {
-    study_options.push_back({"0:10 (Debug Study)", 0, 10});
-    break_options.push_back({"0:05 (Debug Break)", 0, 5});
+    study_options.push_back({"0:10 (Debug Study)", 10s});
+    break_options.push_back({"0:05 (Debug Break)", 5s});
   }
 
   std::vector<std::string> study_labels;
@@ -44,24 +59,334 @@ int main(int argc, char* argv[]) {
     break_labels.push_back(opt.label);
   }
 
-  int study_choice = prompt_selection("Select Study Time:", study_labels, true);
+  int study_choice =
+      prompt_selection(screen, "Select Study Time:", study_labels, true);
   if (study_choice == -1) {
-    endwin();
-    return 0;
+    return false;
   }
-  int break_choice = prompt_selection("Select Break Time:", break_labels, true);
+  int break_choice =
+      prompt_selection(screen, "Select Break Time:", break_labels, true);
   if (break_choice == -1) {
-    endwin();
-    return 0;
+    return false;
   }
 
-  nodelay(stdscr, TRUE);
+  pomodoro = {study_options[study_choice].length};
+  brk = {break_options[break_choice].length};
+  return true;
+}
+
+// Parses a whole number of minutes from a --study= or --break= value
+bool parse_minutes(std::string_view text, SessionTime& length) {
+  int minutes = 0;
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), minutes);
+  if (error != std::errc() || end != text.data() + text.size() ||
+      minutes <= 0) {
+    return false;
+  }
+  length = {std::chrono::minutes(minutes)};
+  return true;
+}
 
-  SessionTime pomodoro{study_options[study_choice].minutes,
-                       study_options[study_choice].seconds};
-  SessionTime brk{break_options[break_choice].minutes,
-                  break_options[break_choice].seconds};
-  pomodoro_event_loop(pomodoro, brk);
-  endwin();
+// Shows the daemon's session until the user detaches or the daemon goes away
+int attach(int fd, const std::string& timer, Clock& clock, Screen& screen,
+           bool stats_mode) {
+  LoopStats stats{};
+  const ClientExit exit = client_event_loop(fd, timer, clock, screen,
+                                            stats_mode ? &stats : nullptr);
+  close(fd);
+  if (exit == ClientExit::kShutdown) {
+    return kSignalExitBase + shutdown_signal();
+  }
+  return exit == ClientExit::kDisconnected ? 1 : 0;
+}
+
+// A status bar line for an active timer, e.g. "Running 24:59"
+std::string status_line(const StatusSnapshot& snapshot) {
+  DurationText left{};
+  return std::string(status_text(snapshot.status)) + " " +
+         format_duration(
+             std::chrono::ceil<std::chrono::seconds>(snapshot.remaining),
+             left);
+}
+
+// Prints the published session for a status bar; fails when no timer is
+// publishing
+int print_status(const std::string& path) {
+  SteadyClock clock;
+  StatusReader reader;
+  StatusSnapshot snapshot{};
+  if (!reader.open(path) || !reader.read(clock.now(), snapshot) ||
+      !snapshot.active) {
+    return 1;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  std::printf("%s\n", status_line(snapshot).c_str());
   return 0;
 }
+
+// --status --follow, for status bars that keep one reader running (polybar's
+// tail = true): prints a line whenever the text changes, and an empty one
+// while no timer is publishing. Nothing tells readers about changes, so it
+// looks again as each displayed second ends and at least every
+// kFollowInterval, which costs no system calls beyond the sleep. Without a
+// live publisher the file is reopened each time, since a new timer may have
+// replaced it.
+int follow_status(const std::string& path) {
+  shutdown_install();
+  SteadyClock clock;
+  std::optional<StatusReader> reader;
+  std::string shown;
+  bool printed = false;
+  const std::array<int, 1> wait_fds = {shutdown_fd()};
+  while (shutdown_signal() == 0) {
+    if (!reader) {
+      reader.emplace();
+      if (!reader->open(path)) {
+        reader.reset();
+      }
+    }
+    const Clock::time_point now = clock.now();
+    StatusSnapshot snapshot{};
+    const bool live =
+        reader && reader->read(now, snapshot) && snapshot.active;
+    if (!live) {
+      reader.reset();
+    }
+    std::string line = live ? status_line(snapshot) : std::string();
+    if (!printed || line != shown) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+      if (std::printf("%s\n", line.c_str()) < 0 || std::fflush(stdout) != 0) {
+        return 1;
+      }
+      shown = std::move(line);
+      printed = true;
+    }
+    Clock::time_point wake_at = now + kFollowInterval;
+    if (live && snapshot.counting) {
+      // The displayed second changes when the time left crosses a whole one
+      const Clock::duration into = snapshot.remaining % 1s;
+      wake_at = std::min(wake_at, now + (into > 0ns ? into : 1s));
+    }
+    clock.wait_readable(wait_fds, wake_at);
+  }
+  return kSignalExitBase + shutdown_signal();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // Check for debug, stats, renderer and key binding flags
+  bool debug_mode = false;
+  bool stats_mode = false;
+  std::string renderer_name = "ncurses";
+  std::string keys_path = keymap_config_path();
+  std::string checkpoint_path;
+  bool checkpoint_given = false;
+  std::string socket_path = ipc_default_socket_path();
+  std::string status_path = status_default_path();
+  bool status_query = false;
+  bool status_follow = false;
+  // Started as pomodorod, the program is the daemon
+  const std::string_view program(argv[0]);
+  bool daemon_mode =
+      program.substr(program.rfind('/') + 1) == std::string_view("pomodorod");
+  bool attach_mode = false;
+  std::string timer_name;
+  SessionTime daemon_pomodoro{};
+  SessionTime daemon_brk{};
+  std::size_t daemon_shards =
+      std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1,
+                              kMaxShards);
+  for (int arg_index = 1; arg_index < argc; ++arg_index) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) //
+    // Standard C++ argv usage
+    const std::string arg(argv[arg_index]);
+    if (arg == "--debug") {
+      debug_mode = true;
+    } else if (arg == "--stats") {
+      stats_mode = true;
+    } else if (arg.starts_with("--renderer=")) {
+      renderer_name = arg.substr(std::string_view("--renderer=").size());
+    } else if (arg.starts_with("--keys=")) {
+      keys_path = arg.substr(std::string_view("--keys=").size());
+    } else if (arg.starts_with("--checkpoint=")) {
+      checkpoint_path = arg.substr(std::string_view("--checkpoint=").size());
+      checkpoint_given = true;
+    } else if (arg == "--daemon") {
+      daemon_mode = true;
+    } else if (arg == "--attach") {
+      attach_mode = true;
+    } else if (arg.starts_with("--timer=")) {
+      timer_name = arg.substr(std::string_view("--timer=").size());
+      if (timer_name.size() > kMaxTimerNameLength) {
+        std::fprintf(stderr, "pomodoro: timer name longer than %zu bytes\n",
+                     kMaxTimerNameLength);
+        return 1;
+      }
+    } else if (arg.starts_with("--socket=")) {
+      socket_path = arg.substr(std::string_view("--socket=").size());
+    } else if (arg == "--status") {
+      status_query = true;
+    } else if (arg == "--follow") {
+      status_follow = true;
+    } else if (arg.starts_with("--status-file=")) {
+      status_path = arg.substr(std::string_view("--status-file=").size());
+    } else if (arg.starts_with("--shards=")) {
+      const std::string_view value =
+          std::string_view(arg).substr(std::string_view("--shards=").size());
+      const auto [end, error] = std::from_chars(
+          value.data(), value.data() + value.size(), daemon_shards);
+      if (error != std::errc() || end != value.data() + value.size() ||
+          daemon_shards < 1 || daemon_shards > kMaxShards) {
+        std::fprintf(stderr, "pomodoro: shards must be 1 to %zu\n",
+                     kMaxShards);
+        return 1;
+      }
+    } else if (arg.starts_with("--study=")) {
+      if (!parse_minutes(arg.substr(std::string_view("--study=").size()),
+                         daemon_pomodoro)) {
+        std::fprintf(stderr, "pomodoro: bad study length '%s'\n", arg.c_str());
+        return 1;
+      }
+    } else if (arg.starts_with("--break=")) {
+      if (!parse_minutes(arg.substr(std::string_view("--break=").size()),
+                         daemon_brk)) {
+        std::fprintf(stderr, "pomodoro: bad break length '%s'\n", arg.c_str());
+        return 1;
+      }
+    }
+  }
+  if (status_follow && !status_query) {
+    std::fprintf(stderr, "pomodoro: --follow needs --status\n");
+    return 1;
+  }
+  if (status_query) {
+    return status_follow ? follow_status(status_path)
+                         : print_status(status_path);
+  }
+  if (!checkpoint_given) {
+    checkpoint_path =
+        checkpoint_default_path(daemon_mode ? "daemon.checkpoint"
+                                            : "checkpoint");
+  }
+  // One process per checkpoint: a second TUI (or daemon) on the same file
+  // runs without one rather than taking over or deleting the first's session
+  CheckpointLock checkpoint_lock;
+  if (!attach_mode && !checkpoint_path.empty() &&
+      !checkpoint_lock.acquire(checkpoint_path)) {
+    std::fprintf(stderr,
+                 "pomodoro: checkpoint '%s' is in use by another pomodoro; "
+                 "this session will not be saved\n",
+                 checkpoint_path.c_str());
+    checkpoint_path.clear();
+  }
+
+  // A peer that hangs up mid-write must surface as EPIPE, not kill us
+  if (daemon_mode || attach_mode) {
+    std::signal(SIGPIPE, SIG_IGN);
+  }
+  if (daemon_mode) {
+    DaemonConfig config{socket_path, checkpoint_path, status_path,
+                        {debug_mode ? 10s : 25min}, {debug_mode ? 5s : 5min},
+                        daemon_shards};
+    if (daemon_pomodoro.length.count() > 0) {
+      config.pomodoro = daemon_pomodoro;
+    }
+    if (daemon_brk.length.count() > 0) {
+      config.brk = daemon_brk;
+    }
+    shutdown_install();
+    SteadyClock clock;
+    return daemon_run(config, clock);
+  }
+  // Connect before taking over the terminal so a missing daemon is reported
+  // on a normal screen
+  int daemon_fd = -1;
+  if (attach_mode) {
+    daemon_fd = ipc_connect(socket_path);
+    if (daemon_fd < 0) {
+      std::fprintf(stderr, "pomodoro: no daemon listening on '%s'\n",
+                   socket_path.c_str());
+      return 1;
+    }
+  }
+
+  // Bindings are read before the terminal is taken over so errors reach
+  // stderr
+  Keymap keymap = keymap_defaults();
+  if (std::string error;
+      !keys_path.empty() && !keymap_load(keymap, keys_path, error)) {
+    std::fprintf(stderr, "pomodoro: %s\n", error.c_str());
+    return 1;
+  }
+
+  // Pick up the terminal's character encoding so the backends can tell
+  // whether block glyphs will render; LC_CTYPE only, so number formatting
+  // stays in the C locale
+  std::setlocale(LC_CTYPE, "");
+  auto renderer = make_renderer(renderer_name);
+  if (!renderer) {
+    std::fprintf(stderr, "pomodoro: unknown renderer '%s'\n",
+                 renderer_name.c_str());
+    return 1;
+  }
+  // Installed after the backend has set up the terminal so they replace the
+  // handlers curses installs; every exit then runs the backend's destructor
+  shutdown_install();
+  SteadyClock clock;
+  Screen screen(*renderer, keymap, clock);
+  if (attach_mode) {
+    const int status =
+        attach(daemon_fd, timer_name, clock, screen, stats_mode);
+    renderer.reset();
+    if (status == 1) {
+      std::fprintf(stderr, "pomodoro: lost connection to the daemon\n");
+    }
+    return status;
+  }
+
+  SessionTime pomodoro{};
+  SessionTime brk{};
+  SessionState session{};
+  // An interrupted session resumes straight into the timer, skipping the
+  // menus; time that passed meanwhile counts if it was running
+  if (Checkpoint checkpoint{};
+      !checkpoint_path.empty() &&
+      checkpoint_load(checkpoint_path, checkpoint)) {
+    pomodoro = {checkpoint.study};
+    brk = {checkpoint.brk};
+    session = checkpoint_restore(checkpoint, clock.now(),
+                                 std::chrono::system_clock::now());
+  } else if (choose_sessions(screen, debug_mode, pomodoro, brk)) {
+    session = session_make(pomodoro);
+  } else {
+    // A signal also ends the menus; there is no session yet to checkpoint
+    return shutdown_signal() != 0 ? kSignalExitBase + shutdown_signal() : 0;
+  }
+  // Left unopened when another timer (the daemon, say) already publishes
+  // there, so this one stays out of the status bar
+  StatusPublisher status_file;
+  if (std::string error; !status_path.empty()) {
+    status_file.open(status_path, error);
+  }
+  LoopStats stats{};
+  if (!pomodoro_event_loop(pomodoro, brk, session, clock, screen,
+                           checkpoint_path, status_file,
+                           stats_mode ? &stats : nullptr)) {
+    return 0;
+  }
+
+  // Stopped by a signal: persist the session, then restore the terminal
+  // before reporting anything (screen is not used past this point)
+  const bool saved =
+      checkpoint_path.empty() ||
+      checkpoint_save(checkpoint_path,
+                      checkpoint_make(pomodoro, brk, session, clock.now(),
+                                      std::chrono::system_clock::now()));
+  renderer.reset();
+  if (!saved) {
+    std::fprintf(stderr, "pomodoro: could not write checkpoint '%s'\n",
+                 checkpoint_path.c_str());
+  }
+  return kSignalExitBase + shutdown_signal();
+}
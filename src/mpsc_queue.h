@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov's
+// linked-list design). push() is one atomic exchange and may be called
+// from any thread; pop() belongs to the single consumer thread. A push
+// that has swapped the head but not yet linked its node is briefly
+// invisible to pop(), so producers wake the consumer only after push()
+// returns.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node), tail_(head_.load()) {}
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+  MpscQueue(MpscQueue&&) = delete;
+  MpscQueue& operator=(MpscQueue&&) = delete;
+  ~MpscQueue() {
+    while (pop()) {
+    }
+    delete tail_;
+  }
+
+  void push(T value) {
+    auto* node = new Node;
+    node->value.emplace(std::move(value));
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  // The oldest value, or nothing if the queue is (momentarily) empty
+  std::optional<T> pop() {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+    std::optional<T> value = std::move(next->value);
+    next->value.reset();
+    delete tail_;
+    // The popped node becomes the new empty sentinel
+    tail_ = next;
+    return value;
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    std::optional<T> value;
+  };
+
+  // Newest node, swapped by producers
+  std::atomic<Node*> head_;
+  // Sentinel before the oldest value, owned by the consumer
+  Node* tail_;
+};
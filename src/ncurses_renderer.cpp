@@ -0,0 +1,52 @@
+#include "ncurses_renderer.h"
+
+#include <ncurses.h>
+#include <unistd.h>
+
+#include <string_view>
+
+#include "utf8.h"
+
+NcursesRenderer::NcursesRenderer() {
+  initscr();
+  cbreak();
+  noecho();
+  nodelay(stdscr, FALSE);
+  keypad(stdscr, TRUE);
+}
+
+NcursesRenderer::~NcursesRenderer() { endwin(); }
+
+TermSize NcursesRenderer::size() const {
+  TermSize term{};
+  getmaxyx(stdscr, term.rows, term.cols);
+  return term;
+}
+
+void NcursesRenderer::put(int row, int col, std::string_view text,
+                          Attr attr) {
+  if (attr == Attr::kReverse) {
+    attron(A_REVERSE);
+  }
+  mvaddnstr(row, col, text.data(), static_cast<int>(text.size()));
+  if (attr == Attr::kReverse) {
+    attroff(A_REVERSE);
+  }
+}
+
+void NcursesRenderer::flush() { refresh(); }
+
+void NcursesRenderer::clear() {
+  erase();
+  clearok(stdscr, TRUE);
+}
+
+int NcursesRenderer::read_key(bool block) {
+  nodelay(stdscr, block ? FALSE : TRUE);
+  return getch();
+}
+
+int NcursesRenderer::input_fd() const { return STDIN_FILENO; }
+
+// ncursesw decodes multibyte text itself, but only in a UTF-8 locale
+bool NcursesRenderer::unicode() const { return utf8_locale(); }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string_view>
+
+#include "renderer.h"
+
+// Backend drawing through ncurses; curses keeps its own copy of the screen
+// and emits the minimal update on refresh()
+class NcursesRenderer final : public Renderer {
+ public:
+  NcursesRenderer();
+  NcursesRenderer(const NcursesRenderer&) = delete;
+  NcursesRenderer& operator=(const NcursesRenderer&) = delete;
+  NcursesRenderer(NcursesRenderer&&) = delete;
+  NcursesRenderer& operator=(NcursesRenderer&&) = delete;
+  ~NcursesRenderer() override;
+
+  [[nodiscard]] TermSize size() const override;
+  void put(int row, int col, std::string_view text, Attr attr) override;
+  void flush() override;
+  void clear() override;
+  int read_key(bool block) override;
+  [[nodiscard]] int input_fd() const override;
+  [[nodiscard]] bool unicode() const override;
+};
@@ -0,0 +1,46 @@
+#include "outbox.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "ipc.h"
+
+MessageRef message_make(const SessionEvent& event) {
+  auto message = std::make_shared<SharedMessage>();
+  message->length = ipc_encode_event(event, message->bytes);
+  return message;
+}
+
+// A message nothing has been written of yet is replaced outright; one that
+// is part-way out has to finish first so the stream stays framed
+void outbox_push(Outbox& outbox, MessageRef message) {
+  if (!outbox.sending || outbox.offset == 0) {
+    outbox.sending = std::move(message);
+    outbox.offset = 0;
+    outbox.queued.reset();
+  } else {
+    outbox.queued = std::move(message);
+  }
+}
+
+FlushResult outbox_flush(Outbox& outbox, int fd) {
+  while (outbox.sending) {
+    const auto pending = std::span<const std::uint8_t>(outbox.sending->bytes)
+                             .subspan(outbox.offset,
+                                      outbox.sending->length - outbox.offset);
+    const std::ptrdiff_t written = ipc_write_some(fd, pending);
+    if (written < 0) {
+      return FlushResult::kError;
+    }
+    outbox.offset += static_cast<std::size_t>(written);
+    if (outbox.offset < outbox.sending->length) {
+      return FlushResult::kBlocked;
+    }
+    outbox.sending = std::move(outbox.queued);
+    outbox.offset = 0;
+  }
+  return FlushResult::kDone;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "ipc.h"
+
+// An encoded event. The daemon encodes each state change once and every
+// client's outbox holds a reference to the same bytes.
+struct SharedMessage {
+  std::array<std::uint8_t, kMaxMessageLength> bytes;
+  std::size_t length;
+};
+using MessageRef = std::shared_ptr<const SharedMessage>;
+
+MessageRef message_make(const SessionEvent& event);
+
+// Outgoing side of one client connection. Every event is a full snapshot of
+// the session, so a client that falls behind only ever needs the newest one:
+// at most the message being written and one queued message are held, and a
+// newer event replaces the queued one instead of growing a backlog.
+struct Outbox {
+  MessageRef sending;
+  std::size_t offset;
+  MessageRef queued;
+};
+
+enum class FlushResult : std::uint8_t { kDone, kBlocked, kError };
+
+void outbox_push(Outbox& outbox, MessageRef message);
+// Writes as much as the socket takes; kBlocked means wait for it to drain
+FlushResult outbox_flush(Outbox& outbox, int fd);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#ifdef POMODORO_USE_EPOLL
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+// A descriptor that became ready, identified by the tag it was added with.
+// Hang-ups and errors count as readable so the owner's next read sees them.
+struct PollEvent {
+  std::uint64_t tag;
+  bool readable;
+  bool writable;
+};
+
+// Readiness wait over a changing set of descriptors for the daemon. Built on
+// epoll where CMake finds it (Linux), so a wakeup costs the number of ready
+// descriptors rather than the number of connections; elsewhere it falls back
+// to poll() over a dense array. Level-triggered in both cases.
+class Poller {
+ public:
+  Poller();
+  Poller(const Poller&) = delete;
+  Poller& operator=(const Poller&) = delete;
+  Poller(Poller&&) = delete;
+  Poller& operator=(Poller&&) = delete;
+  ~Poller();
+
+  // False if the backend could not be created
+  [[nodiscard]] bool ok() const;
+  // Watches fd for input
+  bool add(int fd, std::uint64_t tag);
+  // Also watches fd for room to write while want_write is set
+  bool set_write(int fd, std::uint64_t tag, bool want_write);
+  // Stops watching fd; call before closing it
+  void remove(int fd);
+  // Waits up to timeout_ms (-1 for ever); the events stay valid until the
+  // next call
+  std::span<const PollEvent> wait(int timeout_ms);
+
+ private:
+#ifdef POMODORO_USE_EPOLL
+  int epoll_fd_;
+  std::vector<epoll_event> ready_;
+#else
+  std::vector<pollfd> fds_;
+  std::vector<std::uint64_t> tags_;
+  // Position of each descriptor in fds_, indexed by descriptor
+  std::vector<int> slots_;
+#endif
+  std::vector<PollEvent> events_;
+};
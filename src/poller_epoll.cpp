@@ -0,0 +1,60 @@
+#include "poller.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <span>
+
+namespace {
+// Ready descriptors taken per wakeup; with level triggering the rest are
+// reported again by the next wait
+constexpr std::size_t kMaxReady = 256;
+
+bool control(int epoll_fd, int operation, int fd, std::uint64_t tag,
+             bool want_write) {
+  epoll_event event{};
+  event.events = EPOLLIN | (want_write ? EPOLLOUT : 0U);
+  event.data.u64 = tag;
+  return epoll_ctl(epoll_fd, operation, fd, &event) == 0;
+}
+}  // namespace
+
+Poller::Poller() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
+  ready_.resize(kMaxReady);
+  events_.reserve(kMaxReady);
+}
+
+Poller::~Poller() {
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+}
+
+bool Poller::ok() const { return epoll_fd_ >= 0; }
+
+bool Poller::add(int fd, std::uint64_t tag) {
+  return control(epoll_fd_, EPOLL_CTL_ADD, fd, tag, false);
+}
+
+bool Poller::set_write(int fd, std::uint64_t tag, bool want_write) {
+  return control(epoll_fd_, EPOLL_CTL_MOD, fd, tag, want_write);
+}
+
+void Poller::remove(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+std::span<const PollEvent> Poller::wait(int timeout_ms) {
+  events_.clear();
+  const int count = epoll_wait(epoll_fd_, ready_.data(),
+                               static_cast<int>(ready_.size()), timeout_ms);
+  for (int i = 0; i < count; ++i) {
+    const epoll_event& event = ready_[static_cast<std::size_t>(i)];
+    events_.push_back(
+        {event.data.u64,
+         (event.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0,
+         (event.events & EPOLLOUT) != 0});
+  }
+  return events_;
+}
@@ -0,0 +1,70 @@
+#include "poller.h"
+
+#include <poll.h>
+
+#include <cstdint>
+#include <span>
+
+Poller::Poller() = default;
+
+Poller::~Poller() = default;
+
+bool Poller::ok() const { return true; }
+
+bool Poller::add(int fd, std::uint64_t tag) {
+  if (fd < 0) {
+    return false;
+  }
+  const auto index = static_cast<std::size_t>(fd);
+  if (index >= slots_.size()) {
+    slots_.resize(index + 1, -1);
+  }
+  slots_[index] = static_cast<int>(fds_.size());
+  fds_.push_back({fd, POLLIN, 0});
+  tags_.push_back(tag);
+  return true;
+}
+
+bool Poller::set_write(int fd, std::uint64_t tag, bool want_write) {
+  const auto index = static_cast<std::size_t>(fd);
+  if (fd < 0 || index >= slots_.size() || slots_[index] < 0) {
+    return false;
+  }
+  const auto slot = static_cast<std::size_t>(slots_[index]);
+  fds_[slot].events = static_cast<short>(POLLIN | (want_write ? POLLOUT : 0));
+  tags_[slot] = tag;
+  return true;
+}
+
+// Moves the last entry into the hole so the array stays dense
+void Poller::remove(int fd) {
+  const auto index = static_cast<std::size_t>(fd);
+  if (fd < 0 || index >= slots_.size() || slots_[index] < 0) {
+    return;
+  }
+  const auto slot = static_cast<std::size_t>(slots_[index]);
+  slots_[index] = -1;
+  if (slot + 1 != fds_.size()) {
+    fds_[slot] = fds_.back();
+    tags_[slot] = tags_.back();
+    slots_[static_cast<std::size_t>(fds_[slot].fd)] = static_cast<int>(slot);
+  }
+  fds_.pop_back();
+  tags_.pop_back();
+}
+
+std::span<const PollEvent> Poller::wait(int timeout_ms) {
+  events_.clear();
+  if (poll(fds_.data(), fds_.size(), timeout_ms) <= 0) {
+    return events_;
+  }
+  for (std::size_t i = 0; i < fds_.size(); ++i) {
+    const short revents = fds_[i].revents;
+    if (revents != 0) {
+      events_.push_back({tags_[i],
+                         (revents & (POLLIN | POLLHUP | POLLERR)) != 0,
+                         (revents & POLLOUT) != 0});
+    }
+  }
+  return events_;
+}
@@ -2,282 +2,442 @@
 
 #include <ncurses.h>
 
-#include <atomic>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <string>
-#include <thread>
+#include <string_view>
 #include <vector>
 
+#include "alloc_count.h"
+#include "checkpoint.h"
+#include "shutdown.h"
+#include "timer_screen.h"
+
 using namespace std::chrono;
 
 // Magic numbers and UI constants
-constexpr int kMenuPromptRow = 1;
-constexpr int kMenuOptionStartRow = 3;
 constexpr int kMenuHelpRowOffset = 1;
-constexpr int kBreakPromptRow = 3;
-constexpr int kBreakHelpRow = 5;
-constexpr int kStatusRow = 7;
-constexpr int kControlRow = 5;
-constexpr int kTimeRow = 3;
-constexpr int kSecondsPerMinute = 60;
-constexpr int kMicrosecondsPerSecond = 1'000'000;
-constexpr int kMicrosecondsPerMinute = 60'000'000;
-constexpr int kIntervalUs = 10'000;
+// U+2588 FULL BLOCK, then LEFT ONE EIGHTH BLOCK .. LEFT SEVEN EIGHTHS BLOCK
+constexpr char32_t kFullBlock = U'\u2588';
+constexpr std::array<char32_t, 7> kEighthBlocks = {
+    U'\u258F', U'\u258E', U'\u258D', U'\u258C',
+    U'\u258B', U'\u258A', U'\u2589'};
 constexpr int kShortStudyMinutes = 25;
 constexpr int kLongStudyMinutes = 50;
 constexpr int kShortBreakMinutes = 5;
 constexpr int kLongBreakMinutes = 10;
 constexpr int kDebugStudySeconds = 10;
 constexpr int kDebugBreakSeconds = 5;
-constexpr int kEnterKey = 10;
+// Printable ASCII typed into a menu extends its filter
+constexpr int kFirstFilterKey = ' ';
+constexpr int kLastFilterKey = '~';
 
 namespace {
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) //
-// Required for ncurses TUI state
-std::atomic<bool> running{false};
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) //
-// Required for ncurses TUI state
-std::atomic<bool> paused{false};
+// Prints label followed by the duration
+void print_duration(Screen& target, int row, int col, const char* label,
+                    seconds value) {
+  DurationText text{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  target.printf(row, col, "%s%s", label, format_duration(value, text));
+}
+
+// Draws the rows that follow the clock: the time and the progress bar
+void draw_clock_rows(Screen& screen, const TimerView& view) {
+  const Layout& layout = screen.layout();
+  print_duration(screen, layout.time_row, layout.margin, "Time: ",
+                 view.display);
+  // Progress bar: whole cells, then at most one partial eighth-block cell
+  // when the layout has sub-cell resolution
+  const int width = layout.bar_width;
+  const int fill = std::clamp(view.bar_fill, 0, layout.bar_steps);
+  const int full = fill / layout.bar_resolution;
+  const int partial = fill % layout.bar_resolution;
+  const int bar_col = layout.margin + 1;
+  screen.print(layout.bar_row, layout.margin, "[");
+  screen.fill(layout.bar_row, bar_col, full,
+              layout.bar_resolution > 1 ? kFullBlock : U'#');
+  if (partial > 0) {
+    screen.fill(layout.bar_row, bar_col + full, 1,
+                kEighthBlocks.at(partial - 1));
+  }
+  screen.print(layout.bar_row, bar_col + width, "]");
+}
+
+// Draws the --stats diagnostics block below the status line
+void draw_stats(Screen& screen, const LoopStats& stats) {
+  const Layout& layout = screen.layout();
+  const int row = layout.stats_row;
+  const int col = layout.margin;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  screen.printf(row, col, "Wakeups: %llu total, %llu/min, %llu keys, max %llu",
+                static_cast<unsigned long long>(stats.wakeups.total),
+                static_cast<unsigned long long>(
+                    rate_per_minute(stats.wakeups, stats.last_wakeup)),
+                static_cast<unsigned long long>(stats.keys.total),
+                static_cast<unsigned long long>(stats.max_keys_per_wakeup));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  screen.printf(row + 1, col, "Frames:  %llu total, %llu/min",
+                static_cast<unsigned long long>(stats.frames.total),
+                static_cast<unsigned long long>(
+                    rate_per_minute(stats.frames, stats.last_wakeup)));
+  if (allocations_counted()) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    screen.printf(row + 2, col, "Allocs:  %llu in loop, %llu/min",
+                  static_cast<unsigned long long>(stats.allocations.total),
+                  static_cast<unsigned long long>(
+                      rate_per_minute(stats.allocations, stats.last_wakeup)));
+  } else {
+    screen.print(row + 2, col,
+                 "Allocs:  not counted, needs POMODORO_COUNT_ALLOCATIONS");
+  }
+  const OutputStats* output = screen.renderer().output_stats();
+  if (output == nullptr || output->frames == 0) {
+    screen.print(row + 3, col, "Output:  not observable with this backend");
+    return;
+  }
+  const double frames = static_cast<double>(output->frames);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  screen.printf(row + 3, col,
+                "Output:  %.1f cells, %.1f bytes, %.2f writes per frame",
+                static_cast<double>(output->cells) / frames,
+                static_cast<double>(output->bytes) / frames,
+                static_cast<double>(output->writes) / frames);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  screen.printf(row + 4, col,
+                "Writes:  %llu/min, %llu bytes/min, %llu frames over budget",
+                static_cast<unsigned long long>(
+                    rate_per_minute(stats.writes, stats.last_wakeup)),
+                static_cast<unsigned long long>(
+                    rate_per_minute(stats.bytes, stats.last_wakeup)),
+                static_cast<unsigned long long>(output->frames_over_budget));
+}
+
+// Number of menu items that fit on screen at once
+int menu_page_rows(const Layout& layout, int num_items) {
+  return std::min(num_items, layout.menu_rows);
+}
+
+// Moves the highlight to choice, scrolling the window just far enough to
+// keep it visible
+MenuCursor menu_scroll_to(MenuCursor cursor, int choice, int page_rows) {
+  cursor.choice = choice;
+  if (choice < cursor.first) {
+    cursor.first = choice;
+  } else if (choice >= cursor.first + page_rows) {
+    cursor.first = choice - page_rows + 1;
+  }
+  return cursor;
+}
 }  // namespace
 
 // Presents a menu for the user to select an option using arrow keys and enter
-// Returns -1 if the user selects the quit option
-int prompt_selection(const std::string& prompt,
+// Returns -1 if the user selects the quit option. Moving the highlight within
+// the window repaints only the old and new rows; the window is redrawn only
+// when it scrolls, the filter changes or the terminal is resized, so each key
+// costs O(visible rows) whatever the number of options. Typing narrows the
+// list to options containing the typed letters in order; backspace widens it.
+int prompt_selection(Screen& screen, const std::string& prompt,
                      const std::vector<std::string>& options, bool allow_quit) {
-  int choice = 0;
-  int key_code = 0;
-  int num_options = static_cast<int>(options.size());
-  int max_choice = allow_quit ? num_options : num_options - 1;
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  MenuCursor cursor{0, 0};
+  draw_menu(screen, prompt, options, filter, cursor, allow_quit);
   while (true) {
-    draw_menu(prompt, options, choice, allow_quit);
-    key_code = getch();
-    if (key_code == KEY_UP) {
-      choice = (choice - 1 + (max_choice + 1)) % (max_choice + 1);
-    } else if (key_code == KEY_DOWN) {
-      choice = (choice + 1) % (max_choice + 1);
-    } else if (key_code == '\n' || key_code == '\r' || key_code == kEnterKey) {
-      if (allow_quit && choice == num_options) {
-        return -1;
+    const int key_code = screen.read_key(true);
+    const Action action = screen.action(KeyContext::kMenu, key_code);
+    if (action == Action::kNone) {
+      if (key_code >= kFirstFilterKey && key_code <= kLastFilterKey) {
+        fuzzy_filter_push(filter, options, static_cast<char>(key_code));
+        cursor = {0, 0};
+        draw_menu(screen, prompt, options, filter, cursor, allow_quit);
+      }
+      continue;
+    }
+    if (action == Action::kErase) {
+      if (!filter.query.empty()) {
+        fuzzy_filter_pop(filter);
+        cursor = {0, 0};
+        draw_menu(screen, prompt, options, filter, cursor, allow_quit);
+      }
+      continue;
+    }
+    if (action == Action::kQuit) {
+      // Also bound to the end of input (headless run)
+      return -1;
+    }
+    const auto& matches = fuzzy_filter_matches(filter);
+    const int num_matches = static_cast<int>(matches.size());
+    const int num_items = allow_quit ? num_matches + 1 : num_matches;
+    if (action == Action::kResize || num_items == 0) {
+      if (num_items > 0) {
+        // The window may have shrunk below the highlighted row
+        const int page_rows = menu_page_rows(screen.layout(), num_items);
+        cursor.first = std::clamp(cursor.first, 0, num_items - page_rows);
+        cursor = menu_scroll_to(cursor, cursor.choice, page_rows);
       }
-      return choice;
+      draw_menu(screen, prompt, options, filter, cursor, allow_quit);
+      continue;
+    }
+    const int page_rows = menu_page_rows(screen.layout(), num_items);
+    int choice = cursor.choice;
+    switch (action) {
+      case Action::kUp:
+        choice = (choice - 1 + num_items) % num_items;
+        break;
+      case Action::kDown:
+        choice = (choice + 1) % num_items;
+        break;
+      case Action::kPageUp:
+        choice = std::max(0, choice - page_rows);
+        break;
+      case Action::kPageDown:
+        choice = std::min(num_items - 1, choice + page_rows);
+        break;
+      case Action::kHome:
+        choice = 0;
+        break;
+      case Action::kEnd:
+        choice = num_items - 1;
+        break;
+      case Action::kConfirm:
+        return choice == num_matches ? -1 : matches[choice].index;
+      default:
+        break;
+    }
+    if (choice == cursor.choice) {
+      continue;
     }
+    const MenuCursor moved = menu_scroll_to(cursor, choice, page_rows);
+    if (moved.first != cursor.first) {
+      cursor = moved;
+      draw_menu(screen, prompt, options, filter, cursor, allow_quit);
+      continue;
+    }
+    const int previous = cursor.choice;
+    cursor = moved;
+    draw_menu_item(screen, options, matches, cursor, previous);
+    draw_menu_item(screen, options, matches, cursor, cursor.choice);
+    screen.present();
   }
 }
 
 // Prompts the user after a session, showing session durations and allowing exit
-bool prompt_continue(const char* msg, const SessionTime& study,
-                     const SessionTime& brk, bool is_break) {
-  clear();
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kBreakPromptRow, 2, "%s", msg);
-  if (is_break) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-    mvprintw(kBreakHelpRow, 2, "Break time: %02d:%02d", brk.minutes,
-             brk.seconds);
-  } else {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-    mvprintw(kBreakHelpRow, 2, "Study time: %02d:%02d", study.minutes,
-             study.seconds);
-  }
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kStatusRow, 2, "Press any key to continue, or 'q' to exit...");
-  refresh();
-  nodelay(stdscr, FALSE);
-  int key_code = getch();
-  nodelay(stdscr, TRUE);
-  return key_code != 'q' && key_code != 'Q';
-}
-
-// Returns true if the timer has finished, false otherwise
-bool timer_tick(TimerTickState& state, int interval_us) {
-  state.elapsed_us += interval_us;
-  if (state.elapsed_us >= kMicrosecondsPerSecond) {
-    state.elapsed_us = 0;
-    if (state.total_seconds > 0) {
-      --state.total_seconds;
+bool prompt_continue(Screen& screen, const char* msg,
+                     const SessionTime& study, const SessionTime& brk,
+                     bool is_break) {
+  Action action = Action::kResize;
+  // Repaint with the new layout whenever the terminal is resized
+  while (action == Action::kResize) {
+    const Layout& layout = screen.layout();
+    screen.begin_frame();
+    screen.print(layout.prompt_row, layout.margin, msg);
+    if (is_break) {
+      print_duration(screen, layout.prompt_detail_row, layout.margin,
+                     "Break time: ", brk.length);
     } else {
-      return true;
+      print_duration(screen, layout.prompt_detail_row, layout.margin,
+                     "Study time: ", study.length);
     }
+    screen.print(layout.prompt_help_row, layout.margin,
+                 "Press any key to continue, or 'q' to exit...");
+    screen.present();
+    action = screen.action(KeyContext::kPrompt, screen.read_key(true));
   }
-  return false;
+  return action != Action::kQuit;
 }
 
 // Handles the transition between study and break sessions
 bool handle_session_transition(bool& on_break, SessionTime& current,
                                TimerTickState& tick_state,
                                const SessionTime& pomodoro,
-                               const SessionTime& brk, std::string& status) {
+                               const SessionTime& brk, SessionStatus& status,
+                               Clock& clock, Screen& screen) {
   if (!on_break) {
     on_break = true;
     current = brk;
-    tick_state = {current.minutes * kSecondsPerMinute + current.seconds, 0};
-    status = "Break Ready";
-    if (!prompt_continue("Study session complete! Time for a break.", pomodoro,
-                         brk, true)) {
+    tick_state = timer_make(current.length);
+    status = SessionStatus::kBreakReady;
+    if (!prompt_continue(screen, "Study session complete! Time for a break.",
+                         pomodoro, brk, true)) {
       return false;
     }
-    status = "Break Running";
-    running = true;
+    status = SessionStatus::kBreakRunning;
+    timer_start(tick_state, clock.now());
   } else {
     if (!prompt_continue(
+            screen,
             "Break complete! Press any key to start a new study session.",
             pomodoro, brk, false)) {
       return false;
     }
     on_break = false;
     current = pomodoro;
-    tick_state = {current.minutes * kSecondsPerMinute + current.seconds, 0};
-    status = "Running";
-    running = true;
+    tick_state = timer_make(current.length);
+    status = SessionStatus::kRunning;
+    timer_start(tick_state, clock.now());
   }
   return true;
 }
 
-void pomodoro_event_loop(const SessionTime& pomodoro, const SessionTime& brk) {
-  SessionTime current = pomodoro;
-  TimerTickState tick_state{
-      current.minutes * kSecondsPerMinute + current.seconds, 0};
-  const int initial_total_seconds = tick_state.total_seconds;
-  std::string status = "Stopped";
-  bool on_break = false;
-  draw(current.minutes, current.seconds, status, initial_total_seconds,
-       tick_state.total_seconds);
+bool pomodoro_event_loop(const SessionTime& pomodoro, const SessionTime& brk,
+                         SessionState& session, Clock& clock, Screen& screen,
+                         const std::string& checkpoint_path,
+                         StatusPublisher& status_file, LoopStats* stats) {
+  SessionTime current = session.on_break ? brk : pomodoro;
+  TimerTickState& tick_state = session.tick;
+  SessionStatus& status = session.status;
+  bool& on_break = session.on_break;
+  status_file.publish(session);
+  TimerScreen timer_screen(clock, screen, stats);
+  timer_screen.start(session);
   while (true) {
-    int key_code = getch();
-    if (key_code == 'q') {
+    const bool counting = session_counting(session);
+    timer_screen.wait(session);
+    bool dirty = false;
+    bool changed = false;
+    bool quit = false;
+    for (Action action{}; !quit && timer_screen.next_action(action);) {
+      if (action == Action::kQuit) {
+        quit = true;
+      }
+      if (action == Action::kStartPause) {
+        session_apply(session, SessionCommand::kStartPause, pomodoro, brk,
+                      clock.now());
+        dirty = true;
+        changed = true;
+      }
+      if (action == Action::kReset) {
+        session_apply(session, SessionCommand::kReset, pomodoro, brk,
+                      clock.now());
+        dirty = true;
+        changed = true;
+      }
+    }
+    timer_screen.record_wakeup();
+    // A shutdown signal ends the loop on the iteration it wakes
+    if (quit || shutdown_signal() != 0) {
       break;
     }
-    if (key_code == 's') {
-      if (!running) {
-        running = true;
-        paused = false;
-        status = on_break ? "Break Running" : "Running";
-      } else {
-        paused = !paused;
-        if (paused) {
-          status = on_break ? "Break Paused" : "Paused";
-        } else {
-          status = on_break ? "Break Running" : "Running";
-        }
+    if (counting && timer_tick(tick_state, clock.now())) {
+      if (!handle_session_transition(on_break, current, tick_state, pomodoro,
+                                     brk, status, clock, screen)) {
+        break;
       }
+      dirty = true;
+      changed = true;
     }
-    if (key_code == 'r') {
-      running = false;
-      paused = false;
-      if (on_break) {
-        current = brk;
-      } else {
-        current = pomodoro;
-      }
-      tick_state = {current.minutes * kSecondsPerMinute + current.seconds, 0};
-      status = on_break ? "Break Stopped" : "Stopped";
+    // Checkpoint and publish on state changes only; between them the
+    // countdown follows from the saved deadline
+    if (changed && !checkpoint_path.empty()) {
+      checkpoint_save(checkpoint_path,
+                      checkpoint_make(pomodoro, brk, session, clock.now(),
+                                      system_clock::now()));
     }
-    if (running && !paused) {
-      if (timer_tick(tick_state, kIntervalUs)) {
-        running = false;
-        if (!handle_session_transition(on_break, current, tick_state, pomodoro,
-                                       brk, status)) {
-          break;
-        }
-      }
-      int remaining_us = tick_state.total_seconds * kMicrosecondsPerSecond -
-                         tick_state.elapsed_us;
-      if (remaining_us < 0) {
-        remaining_us = 0;
-      }
-      int display_total_us = remaining_us;
-      int display_minutes = display_total_us / kMicrosecondsPerMinute;
-      int display_seconds =
-          (display_total_us / kMicrosecondsPerSecond) % kSecondsPerMinute;
-      draw(display_minutes, display_seconds, status, initial_total_seconds,
-           tick_state.total_seconds);
-      std::this_thread::sleep_for(std::chrono::microseconds(kIntervalUs));
-    } else {
-      std::this_thread::sleep_for(std::chrono::microseconds(kIntervalUs));
-      int display_total_us = tick_state.total_seconds * kMicrosecondsPerSecond;
-      int display_minutes = display_total_us / kMicrosecondsPerMinute;
-      int display_seconds =
-          (display_total_us / kMicrosecondsPerSecond) % kSecondsPerMinute;
-      draw(display_minutes, display_seconds, status, initial_total_seconds,
-           tick_state.total_seconds);
+    if (changed) {
+      status_file.publish(session);
     }
+    timer_screen.render(session, dirty);
   }
+  const bool interrupted = shutdown_signal() != 0;
+  if (!interrupted && !checkpoint_path.empty()) {
+    // Quit on purpose: the next start shows the menus again
+    checkpoint_remove(checkpoint_path);
+  }
+  return interrupted;
 }
 
-// Helper to draw the menu options (reduces cognitive complexity)
-void draw_menu(const std::string& prompt,
-               const std::vector<std::string>& options, int choice,
+// Draws the prompt and filter, the visible window of matching options and
+// the help line
+void draw_menu(Screen& screen, const std::string& prompt,
+               const std::vector<std::string>& options,
+               const FuzzyFilter& filter, const MenuCursor& cursor,
                bool allow_quit) {
-  clear();
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kMenuPromptRow, 2, "%s", prompt.c_str());
-  int num_options = static_cast<int>(options.size());
-  for (int i = 0; i < num_options; ++i) {
-    if (i == choice) {
-      attron(A_REVERSE);
-    }
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-    mvprintw(kMenuOptionStartRow + i, 4, "%s", options[i].c_str());
-    if (i == choice) {
-      attroff(A_REVERSE);
-    }
+  const Layout& layout = screen.layout();
+  const auto& matches = fuzzy_filter_matches(filter);
+  const int num_matches = static_cast<int>(matches.size());
+  const int num_items = allow_quit ? num_matches + 1 : num_matches;
+  const int page_rows = menu_page_rows(layout, num_items);
+  screen.begin_frame();
+  screen.print(layout.menu_prompt_row, layout.margin, prompt);
+  if (!filter.query.empty()) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    screen.printf(layout.menu_prompt_row,
+                  layout.margin + static_cast<int>(prompt.size()) + 1,
+                  "Filter: %s", filter.query.c_str());
   }
-  int quit_row = kMenuOptionStartRow + num_options;
-  if (allow_quit) {
-    if (choice == num_options) {
-      attron(A_REVERSE);
-    }
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-    mvprintw(quit_row, 4, "Quit");
-    if (choice == num_options) {
-      attroff(A_REVERSE);
-    }
+  for (int i = cursor.first; i < cursor.first + page_rows; ++i) {
+    draw_menu_item(screen, options, matches, cursor, i);
+  }
+  if (num_items == 0) {
+    screen.print(layout.menu_first_row, layout.indent, "(no matches)");
   }
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(quit_row + kMenuHelpRowOffset, 2,
-           "Use UP/DOWN to select, ENTER to confirm");
-  refresh();
+  const int help_row = layout.menu_first_row + std::max(page_rows, 1) - 1 +
+                       kMenuHelpRowOffset;
+  if (page_rows < num_items) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+    screen.printf(help_row, layout.margin,
+                  "%d-%d of %d, UP/DOWN/PgUp/PgDn/Home/End, type to filter",
+                  cursor.first + 1, cursor.first + page_rows, num_items);
+  } else {
+    screen.print(help_row, layout.margin,
+                 "Use UP/DOWN to select, ENTER to confirm, type to filter");
+  }
+  screen.present();
+}
+
+// Draws one matching item in its window row; the item past the last match
+// is Quit
+void draw_menu_item(Screen& screen, const std::vector<std::string>& options,
+                    const std::vector<FuzzyMatch>& matches,
+                    const MenuCursor& cursor, int index) {
+  const Layout& layout = screen.layout();
+  const auto num_matches = static_cast<int>(matches.size());
+  const std::string_view label =
+      index < num_matches ? std::string_view(options[matches[index].index])
+                          : "Quit";
+  screen.print(layout.menu_first_row + index - cursor.first, layout.indent,
+               label, index == cursor.choice ? Attr::kReverse : Attr::kNormal);
 }
 
 // Prompts the user to start a break, blocking until a key is pressed
-void prompt_break(const char* break_msg) {
-  clear();
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kBreakPromptRow, 2, "%s", break_msg);
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kBreakHelpRow, 2, "Press any key to start break timer...");
-  refresh();
-  nodelay(stdscr, FALSE);
-  getch();
-  nodelay(stdscr, TRUE);
+void prompt_break(Screen& screen, const char* break_msg) {
+  Action action = Action::kResize;
+  while (action == Action::kResize) {
+    const Layout& layout = screen.layout();
+    screen.begin_frame();
+    screen.print(layout.prompt_row, layout.margin, break_msg);
+    screen.print(layout.prompt_detail_row, layout.margin,
+                 "Press any key to start break timer...");
+    screen.present();
+    action = screen.action(KeyContext::kPrompt, screen.read_key(true));
+  }
 }
 
 // Draws the main timer UI with a progress bar
-void draw(int minutes, int seconds, const std::string& status,
-          int total_seconds, int remaining_seconds) {
-  constexpr int kBarWidth = 40;
-  clear();
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kMenuPromptRow, 2, "Pomodoro Timer");
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kTimeRow, 2, "Time: %02d:%02d", minutes, seconds);
-  // Draw progress bar
-  int elapsed = total_seconds - remaining_seconds;
-  int fill = 0;
-  if (total_seconds > 0) {
-    if (remaining_seconds == 0 && elapsed > 0) {
-      fill = kBarWidth;
-    } else {
-      fill = (elapsed * kBarWidth) / total_seconds;
-    }
+void draw(Screen& screen, const TimerView& view, SessionStatus status,
+          const LoopStats* stats) {
+  const Layout& layout = screen.layout();
+  screen.begin_frame();
+  screen.print(layout.title_row, layout.margin, "Pomodoro Timer");
+  draw_clock_rows(screen, view);
+  screen.print(layout.control_row, layout.margin,
+               "[s] Start/Pause  [r] Reset  [q] Quit");
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style
+  screen.printf(layout.status_row, layout.margin, "Status: %s",
+                status_text(status));
+  if (stats != nullptr) {
+    draw_stats(screen, *stats);
   }
-  std::string bar =
-      "[" + std::string(fill, '#') + std::string(kBarWidth - fill, ' ') + "]";
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kTimeRow + 1, 2, "%s", bar.c_str());
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kControlRow, 2, "[s] Start/Pause  [r] Reset  [q] Quit");
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // ncurses API
-  mvprintw(kStatusRow, 2, "Status: %s", status.c_str());
-  refresh();
+  screen.present();
+}
+
+// Keeps the previous frame and rewrites only the time and the bar, so a
+// frame where only the clock moved diffs two rows
+void draw_clock(Screen& screen, const TimerView& view) {
+  const Layout& layout = screen.layout();
+  screen.clear_row(layout.time_row);
+  screen.clear_row(layout.bar_row);
+  draw_clock_rows(screen, view);
+  screen.present();
 }
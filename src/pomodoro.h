@@ -1,39 +1,61 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 
-void draw(int minutes, int seconds, const std::string& status,
-          int total_seconds, int remaining_seconds);
+#include "clock.h"
+#include "frame.h"
+#include "fuzzy.h"
+#include "screen.h"
+#include "session.h"
+#include "stats.h"
+#include "status_file.h"
+#include "timer.h"
+
+void draw(Screen& screen, const TimerView& view, SessionStatus status,
+          const LoopStats* stats = nullptr);
+void draw_clock(Screen& screen, const TimerView& view);
 
 struct TimerOption {
   std::string label;
-  int minutes;
-  int seconds;
-};
-
-struct SessionTime {
-  int minutes;
-  int seconds;
+  std::chrono::seconds length;
 };
 
-struct TimerTickState {
-  int total_seconds;
-  int elapsed_us;
+// Highlighted menu item and the first item of the visible window, both
+// counted in the filtered list. Only layout().menu_rows items are ever drawn,
+// however long the list is.
+struct MenuCursor {
+  int choice;
+  int first;
 };
 
-int prompt_selection(const std::string& prompt,
+int prompt_selection(Screen& screen, const std::string& prompt,
                      const std::vector<std::string>& options,
                      bool allow_quit = false);
-void draw_menu(const std::string& prompt,
-               const std::vector<std::string>& options, int choice,
+void draw_menu(Screen& screen, const std::string& prompt,
+               const std::vector<std::string>& options,
+               const FuzzyFilter& filter, const MenuCursor& cursor,
                bool allow_quit);
-void prompt_break(const char* break_msg);
-bool prompt_continue(const char* msg, const SessionTime& study,
-                     const SessionTime& brk, bool is_break);
-bool timer_tick(TimerTickState& state, int interval_us);
+void draw_menu_item(Screen& screen, const std::vector<std::string>& options,
+                    const std::vector<FuzzyMatch>& matches,
+                    const MenuCursor& cursor, int index);
+void prompt_break(Screen& screen, const char* break_msg);
+bool prompt_continue(Screen& screen, const char* msg,
+                     const SessionTime& study, const SessionTime& brk,
+                     bool is_break);
 bool handle_session_transition(bool& on_break, SessionTime& current,
                                TimerTickState& tick_state,
                                const SessionTime& pomodoro,
-                               const SessionTime& brk, std::string& status);
-void pomodoro_event_loop(const SessionTime& pomodoro, const SessionTime& brk);
+                               const SessionTime& brk, SessionStatus& status,
+                               Clock& clock, Screen& screen);
+// Runs the timer screen until the user quits or a shutdown signal arrives;
+// returns true in the latter case, with session holding the state to persist.
+// Every state change is checkpointed to checkpoint_path (unless empty), and
+// the file is removed when the user quits. The same changes go out through
+// status_file for status bars.
+bool pomodoro_event_loop(const SessionTime& pomodoro, const SessionTime& brk,
+                         SessionState& session, Clock& clock, Screen& screen,
+                         const std::string& checkpoint_path,
+                         StatusPublisher& status_file,
+                         LoopStats* stats = nullptr);
@@ -0,0 +1,27 @@
+#include "renderer.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ansi_renderer.h"
+#include "headless_renderer.h"
+#include "ncurses_renderer.h"
+
+std::unique_ptr<Renderer> make_renderer(std::string_view spec) {
+  constexpr std::string_view kRecordPrefix = "record:";
+  if (spec == "ncurses") {
+    return std::make_unique<NcursesRenderer>();
+  }
+  if (spec == "ansi") {
+    return std::make_unique<AnsiRenderer>();
+  }
+  if (spec == "null") {
+    return std::make_unique<NullRenderer>();
+  }
+  if (spec.starts_with(kRecordPrefix) && spec.size() > kRecordPrefix.size()) {
+    return std::make_unique<RecordingRenderer>(
+        std::string(spec.substr(kRecordPrefix.size())));
+  }
+  return nullptr;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+// Display attribute of a cell
+enum class Attr : std::uint8_t { kNormal, kReverse };
+
+struct TermSize {
+  int rows;
+  int cols;
+};
+
+// Output volume of a backend, for --stats. The budget is one write(2) per
+// frame; frames that needed more (partial writes) are counted separately.
+struct OutputStats {
+  std::uint64_t frames;
+  std::uint64_t cells;
+  std::uint64_t writes;
+  std::uint64_t bytes;
+  std::uint64_t frames_over_budget;
+};
+
+// Terminal backend. Screen composes frames and hands the backend only the
+// runs of cells that changed; the backend turns them into terminal output and
+// also owns keyboard input. Key codes follow curses (KEY_UP, KEY_RESIZE, ERR
+// when no key is available) so every backend feeds the same handlers.
+class Renderer {
+ public:
+  Renderer() = default;
+  Renderer(const Renderer&) = delete;
+  Renderer& operator=(const Renderer&) = delete;
+  Renderer(Renderer&&) = delete;
+  Renderer& operator=(Renderer&&) = delete;
+  virtual ~Renderer() = default;
+
+  [[nodiscard]] virtual TermSize size() const = 0;
+  // Writes a run of cells sharing one attribute at row, col
+  virtual void put(int row, int col, std::string_view text, Attr attr) = 0;
+  // Ends a frame, pushing everything put() since the last flush
+  virtual void flush() = 0;
+  // Blanks the terminal; the next frame repaints every cell
+  virtual void clear() = 0;
+
+  // Returns the next key, or ERR when block is false and none is pending
+  virtual int read_key(bool block) = 0;
+  // File descriptor to poll for keyboard input
+  [[nodiscard]] virtual int input_fd() const = 0;
+  // Whether the terminal can show non-ASCII glyphs (UTF-8 text in put())
+  [[nodiscard]] virtual bool unicode() const = 0;
+  // Output accounting, or nullptr when the backend cannot observe its writes
+  [[nodiscard]] virtual const OutputStats* output_stats() const {
+    return nullptr;
+  }
+};
+
+// Creates the backend described by spec: "ncurses", "ansi", "null" or
+// "record:PATH". Returns nullptr if the spec is not recognised.
+std::unique_ptr<Renderer> make_renderer(std::string_view spec);
@@ -0,0 +1,176 @@
+#include "screen.h"
+
+#include <ncurses.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+#include <string_view>
+
+#include "shutdown.h"
+#include "utf8.h"
+
+namespace {
+// Never produced by print(), so a front buffer filled with it differs from
+// every possible back buffer cell
+constexpr char32_t kInvalidCell = U'\0';
+// Longest UTF-8 encoding of one cell
+constexpr std::size_t kMaxCellBytes = 4;
+constexpr int kMaxPrintfLength = 256;
+}  // namespace
+
+Screen::Screen(Renderer& renderer, const Keymap& keymap, Clock& clock)
+    : renderer_(renderer), keymap_(keymap), clock_(clock) {
+  resize(renderer_.size());
+}
+
+void Screen::begin_frame() {
+  std::ranges::fill(back_chars_, U' ');
+  std::ranges::fill(back_attrs_, Attr::kNormal);
+  std::ranges::fill(dirty_rows_, 1);
+}
+
+// Decodes UTF-8 text into the back buffer, one code point per cell,
+// clipping at the right edge
+void Screen::print(int row, int col, std::string_view text, Attr attr) {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_) {
+    return;
+  }
+  dirty_rows_[row] = 1;
+  auto offset = static_cast<std::size_t>((row * cols_) + col);
+  const auto row_end = static_cast<std::size_t>((row + 1) * cols_);
+  while (!text.empty() && offset < row_end) {
+    back_chars_[offset] = utf8_pop(text);
+    back_attrs_[offset] = attr;
+    ++offset;
+  }
+}
+
+void Screen::printf(int row, int col, const char* fmt, ...) {
+  std::array<char, kMaxPrintfLength> buffer{};
+  va_list args;
+  va_start(args, fmt);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) // printf-style helper
+  const int length = std::vsnprintf(buffer.data(), buffer.size(), fmt, args);
+  va_end(args);
+  if (length > 0) {
+    print(row, col,
+          std::string_view(buffer.data(),
+                           std::min<std::size_t>(length, buffer.size() - 1)));
+  }
+}
+
+void Screen::fill(int row, int col, int count, char32_t glyph, Attr attr) {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_ || count <= 0) {
+    return;
+  }
+  dirty_rows_[row] = 1;
+  const auto length = std::min(count, cols_ - col);
+  const auto offset = static_cast<std::size_t>((row * cols_) + col);
+  std::fill_n(back_chars_.begin() + offset, length, glyph);
+  std::fill_n(back_attrs_.begin() + offset, length, attr);
+}
+
+void Screen::clear_row(int row) {
+  if (row < 0 || row >= rows_) {
+    return;
+  }
+  dirty_rows_[row] = 1;
+  const auto offset = static_cast<std::size_t>(row * cols_);
+  std::fill_n(back_chars_.begin() + offset, cols_, U' ');
+  std::fill_n(back_attrs_.begin() + offset, cols_, Attr::kNormal);
+}
+
+// Walks each dirty row and hands maximal runs of changed cells that share an
+// attribute to the renderer as one put()
+void Screen::present() {
+  for (int row = 0; row < rows_; ++row) {
+    if (dirty_rows_[row] == 0) {
+      continue;
+    }
+    dirty_rows_[row] = 0;
+    const auto row_start = static_cast<std::size_t>(row * cols_);
+    // Most rows of a full redraw come out as they were; one bulk compare
+    // settles those without walking them cell by cell
+    const auto row_chars = back_chars_.begin() + row_start;
+    const auto row_attrs = back_attrs_.begin() + row_start;
+    if (std::equal(row_chars, row_chars + cols_,
+                   front_chars_.begin() + row_start) &&
+        std::equal(row_attrs, row_attrs + cols_,
+                   front_attrs_.begin() + row_start)) {
+      continue;
+    }
+    int col = 0;
+    while (col < cols_) {
+      const auto index = row_start + col;
+      if (back_chars_[index] == front_chars_[index] &&
+          back_attrs_[index] == front_attrs_[index]) {
+        ++col;
+        continue;
+      }
+      const Attr attr = back_attrs_[index];
+      int end = col + 1;
+      while (end < cols_) {
+        const auto next = row_start + end;
+        if (back_attrs_[next] != attr ||
+            (back_chars_[next] == front_chars_[next] &&
+             front_attrs_[next] == attr)) {
+          break;
+        }
+        ++end;
+      }
+      run_.clear();
+      for (auto cell = index; cell < row_start + end; ++cell) {
+        utf8_append(run_, back_chars_[cell]);
+      }
+      renderer_.put(row, col, run_, attr);
+      col = end;
+    }
+    std::copy_n(back_chars_.begin() + row_start, cols_,
+                front_chars_.begin() + row_start);
+    std::copy_n(back_attrs_.begin() + row_start, cols_,
+                front_attrs_.begin() + row_start);
+  }
+  renderer_.flush();
+}
+
+void Screen::invalidate() {
+  std::ranges::fill(front_chars_, kInvalidCell);
+  std::ranges::fill(dirty_rows_, 1);
+  renderer_.clear();
+}
+
+// Blocking reads wait on the input and the shutdown pipe through the Clock
+// rather than inside the backend, so a shutdown signal ends them with
+// KEY_EXIT and a simulated run can feed them; keys the backend already
+// buffered are taken before waiting
+int Screen::read_key(bool block) {
+  int key = renderer_.read_key(false);
+  while (block && key == ERR) {
+    if (shutdown_signal() != 0) {
+      return KEY_EXIT;
+    }
+    const std::array<int, 2> fds = {renderer_.input_fd(), shutdown_fd()};
+    clock_.wait_readable(fds, Clock::time_point::max());
+    key = renderer_.read_key(false);
+  }
+  if (key == KEY_RESIZE) {
+    resize(renderer_.size());
+  }
+  return key;
+}
+
+void Screen::resize(TermSize size) {
+  rows_ = std::max(size.rows, 0);
+  cols_ = std::max(size.cols, 0);
+  layout_ = compute_layout(size, renderer_.unicode());
+  const auto cells = static_cast<std::size_t>(rows_) * cols_;
+  back_chars_.assign(cells, U' ');
+  back_attrs_.assign(cells, Attr::kNormal);
+  front_chars_.assign(cells, kInvalidCell);
+  front_attrs_.assign(cells, Attr::kNormal);
+  dirty_rows_.assign(static_cast<std::size_t>(rows_), 1);
+  run_.reserve(static_cast<std::size_t>(cols_) * kMaxCellBytes);
+  renderer_.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clock.h"
+#include "keymap.h"
+#include "layout.h"
+#include "renderer.h"
+
+// Retained-mode screen model. Each frame is composed into a back buffer; on
+// present() it is diffed against the front buffer (what the terminal already
+// shows) and only runs of changed cells are handed to the Renderer, so a
+// frame in which two digits change costs two cells of output instead of a
+// full repaint. Rows that were not written since the last present() are not
+// even compared, so a caller that keeps the previous frame and rewrites two
+// rows pays for two rows. Cells hold code points, so UTF-8 text and block
+// glyphs take one column each and are re-encoded only for the runs that are
+// emitted. The Screen is also the UI's access point to keyboard input; the
+// terminal size and the Layout derived from it are only recomputed when input
+// reports KEY_RESIZE (SIGWINCH), never per frame. Screens translate keys to
+// actions through the Keymap it holds.
+class Screen {
+ public:
+  Screen(Renderer& renderer, const Keymap& keymap, Clock& clock);
+
+  // Starts a new frame by blanking the back buffer. Skipping it keeps the
+  // previous frame, so only rows printed afterwards are re-examined.
+  void begin_frame();
+  void print(int row, int col, std::string_view text,
+             Attr attr = Attr::kNormal);
+  [[gnu::format(printf, 4, 5)]] void printf(int row, int col, const char* fmt,
+                                            ...);
+  // Blanks one row of the back buffer, to redraw it over the previous frame
+  void clear_row(int row);
+  // Writes count copies of glyph starting at row, col
+  void fill(int row, int col, int count, char32_t glyph,
+            Attr attr = Attr::kNormal);
+  // Emits the damaged cells and makes the back buffer the new front buffer
+  void present();
+  // Forgets what the terminal shows so the next present() repaints everything
+  void invalidate();
+
+  // Returns the next key from the renderer, refreshing the cached size and
+  // layout first when it is KEY_RESIZE. A blocking read waits through the
+  // Clock, and a shutdown signal ends it with KEY_EXIT.
+  int read_key(bool block);
+  [[nodiscard]] int input_fd() const { return renderer_.input_fd(); }
+  // Looks up what key does on the given screen
+  [[nodiscard]] Action action(KeyContext context, int key) const {
+    return keymap_lookup(keymap_, context, key);
+  }
+  [[nodiscard]] const Renderer& renderer() const { return renderer_; }
+  [[nodiscard]] const Layout& layout() const { return layout_; }
+
+ private:
+  void resize(TermSize size);
+
+  Renderer& renderer_;
+  const Keymap& keymap_;
+  Clock& clock_;
+  int rows_ = 0;
+  int cols_ = 0;
+  Layout layout_{};
+  std::vector<char32_t> back_chars_;
+  std::vector<Attr> back_attrs_;
+  std::vector<char32_t> front_chars_;
+  std::vector<Attr> front_attrs_;
+  // Rows written since the last present(); only these are diffed
+  std::vector<std::uint8_t> dirty_rows_;
+  // UTF-8 encoding of the run being emitted; sized for a full row at resize
+  std::string run_;
+};
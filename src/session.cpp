@@ -0,0 +1,46 @@
+#include "session.h"
+
+#include "clock.h"
+#include "timer.h"
+
+// Starts a stopped study session
+SessionState session_make(const SessionTime& pomodoro) {
+  return {false, timer_make(pomodoro.length), SessionStatus::kStopped};
+}
+
+bool session_counting(const SessionState& session) {
+  return session.status == SessionStatus::kRunning ||
+         session.status == SessionStatus::kBreakRunning;
+}
+
+// Start/pause toggles between running and paused, starting the phase if it
+// was stopped or waiting; reset stops the current phase at its full length
+void session_apply(SessionState& session, SessionCommand command,
+                   const SessionTime& pomodoro, const SessionTime& brk,
+                   Clock::time_point now) {
+  const bool on_break = session.on_break;
+  if (command == SessionCommand::kReset) {
+    session.tick = timer_make(on_break ? brk.length : pomodoro.length);
+    session.status =
+        on_break ? SessionStatus::kBreakStopped : SessionStatus::kStopped;
+    return;
+  }
+  if (session_counting(session)) {
+    timer_pause(session.tick, now);
+    session.status =
+        on_break ? SessionStatus::kBreakPaused : SessionStatus::kPaused;
+  } else {
+    timer_start(session.tick, now);
+    session.status =
+        on_break ? SessionStatus::kBreakRunning : SessionStatus::kRunning;
+  }
+}
+
+void session_finish(SessionState& session, const SessionTime& pomodoro,
+                    const SessionTime& brk) {
+  if (session.on_break) {
+    session = session_make(pomodoro);
+  } else {
+    session = {true, timer_make(brk.length), SessionStatus::kBreakReady};
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "clock.h"
+#include "timer.h"
+
+// Status line states; the text for each lives in a static table so changing
+// status never allocates
+enum class SessionStatus : std::uint8_t {
+  kStopped,
+  kRunning,
+  kPaused,
+  kBreakReady,
+  kBreakRunning,
+  kBreakPaused,
+  kBreakStopped,
+};
+
+inline constexpr std::array<const char*, 7> kSessionStatusText = {
+    "Stopped",       "Running",      "Paused",        "Break Ready",
+    "Break Running", "Break Paused", "Break Stopped",
+};
+
+constexpr const char* status_text(SessionStatus status) {
+  return kSessionStatusText.at(static_cast<std::size_t>(status));
+}
+
+struct SessionTime {
+  std::chrono::seconds length;
+};
+
+// Engine state of a session: the phase, its countdown and the status line.
+// The event loop updates it in place, so whoever runs the loop can
+// checkpoint it afterwards.
+struct SessionState {
+  bool on_break;
+  TimerTickState tick;
+  SessionStatus status;
+};
+
+// What the s and r keys do, for local keys and remote clients alike
+enum class SessionCommand : std::uint8_t { kStartPause, kReset };
+
+SessionState session_make(const SessionTime& pomodoro);
+// True while the countdown runs (started and not paused)
+bool session_counting(const SessionState& session);
+void session_apply(SessionState& session, SessionCommand command,
+                   const SessionTime& pomodoro, const SessionTime& brk,
+                   Clock::time_point now);
+// Moves a finished phase on to the next one, waiting to be started
+void session_finish(SessionState& session, const SessionTime& pomodoro,
+                    const SessionTime& brk);
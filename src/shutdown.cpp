@@ -0,0 +1,54 @@
+#include "shutdown.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+
+namespace {
+// Lock-free, so the handler may set it and every daemon shard may read it
+static_assert(std::atomic<int>::is_always_lock_free);
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) //
+// Set from the signal handler
+std::atomic<int> received = 0;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) //
+// Self-pipe shared with the signal handler; both ends are non-blocking
+std::array<int, 2> wake_pipe = {-1, -1};
+
+void on_shutdown_signal(int signal) {
+  const int saved_errno = errno;
+  int none = 0;
+  received.compare_exchange_strong(none, signal);
+  const char byte = 0;
+  // A full pipe already guarantees a wakeup, so the result does not matter
+  [[maybe_unused]] const ssize_t written = write(wake_pipe[1], &byte, 1);
+  errno = saved_errno;
+}
+
+void set_nonblocking_cloexec(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+}  // namespace
+
+// Installed without SA_RESTART so a blocking read or poll also returns early
+void shutdown_install() {
+  if (wake_pipe[0] >= 0 || pipe(wake_pipe.data()) != 0) {
+    return;
+  }
+  set_nonblocking_cloexec(wake_pipe[0]);
+  set_nonblocking_cloexec(wake_pipe[1]);
+  struct sigaction action{};
+  action.sa_handler = on_shutdown_signal;
+  sigemptyset(&action.sa_mask);
+  for (const int signal : {SIGINT, SIGTERM, SIGHUP}) {
+    sigaction(signal, &action, nullptr);
+  }
+}
+
+int shutdown_fd() { return wake_pipe[0]; }
+
+int shutdown_signal() { return received; }
@@ -0,0 +1,16 @@
+#pragma once
+
+// Graceful shutdown on SIGINT, SIGTERM and SIGHUP. The handlers only record
+// the signal and write a byte to a self-pipe. The event loop polls the pipe's
+// read end next to its input, so a signal wakes it at once and the process
+// leaves through its normal exit path (checkpoint, terminal restore) instead
+// of dying mid-frame. A self-pipe rather than signalfd keeps this portable to
+// the BSD-derived platforms the flake also builds for.
+void shutdown_install();
+// Read end of the self-pipe, or -1 before shutdown_install()
+int shutdown_fd();
+// The first shutdown signal received, or 0 if none has arrived
+int shutdown_signal();
+// Shell convention for "terminated by signal N": a process that shuts down
+// on a signal exits with this plus N
+constexpr int kSignalExitBase = 128;
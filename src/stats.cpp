@@ -0,0 +1,74 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "alloc_count.h"
+
+using namespace std::chrono;
+
+namespace {
+constexpr auto kWindow = static_cast<std::int64_t>(kRateBuckets);
+
+std::int64_t second_of(Clock::time_point now) {
+  return floor<seconds>(now.time_since_epoch()).count();
+}
+
+std::size_t bucket_index(std::int64_t second) {
+  return static_cast<std::size_t>(((second % kWindow) + kWindow) % kWindow);
+}
+}  // namespace
+
+// Adds amount to the bucket for now, first emptying the buckets of the
+// seconds that passed since the last record
+void rate_record(RateCounter& counter, Clock::time_point now,
+                 std::uint64_t amount) {
+  const std::int64_t second = std::max(second_of(now), counter.last_second);
+  for (std::int64_t stale = std::max(counter.last_second + 1, second - kWindow);
+       stale <= second; ++stale) {
+    counter.buckets.at(bucket_index(stale)) = 0;
+  }
+  counter.last_second = second;
+  counter.total += amount;
+  counter.buckets.at(bucket_index(second)) += amount;
+}
+
+// Sums the buckets of the minute ending at now. Seconds after the newest
+// bucket had no records; their slots still hold older counts and are skipped.
+std::uint64_t rate_per_minute(const RateCounter& counter,
+                              Clock::time_point now) {
+  const std::int64_t newest = counter.last_second;
+  std::uint64_t count = 0;
+  for (std::int64_t second = std::max(second_of(now), newest) - kWindow + 1;
+       second <= newest; ++second) {
+    count += counter.buckets.at(bucket_index(second));
+  }
+  return count;
+}
+
+// Counts one loop wakeup, the keys it drained and the heap allocations made
+// since the last one
+void stats_record_wakeup(LoopStats& stats, Clock::time_point now,
+                         std::uint64_t keys) {
+  stats.last_wakeup = now;
+  rate_record(stats.wakeups, now);
+  rate_record(stats.keys, now, keys);
+  stats.max_keys_per_wakeup = std::max(stats.max_keys_per_wakeup, keys);
+  const std::uint64_t allocations = allocation_count();
+  rate_record(stats.allocations, now, allocations - stats.allocations_seen);
+  stats.allocations_seen = allocations;
+}
+
+// Counts one rendered frame and the write(2) calls and bytes the backend
+// issued for it, when the backend can observe them
+void stats_record_frame(LoopStats& stats, Clock::time_point now,
+                        const OutputStats* output) {
+  rate_record(stats.frames, now);
+  if (output == nullptr) {
+    return;
+  }
+  rate_record(stats.writes, now, output->writes - stats.output_seen.writes);
+  rate_record(stats.bytes, now, output->bytes - stats.output_seen.bytes);
+  stats.output_seen = *output;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "clock.h"
+#include "renderer.h"
+
+// One bucket per second of the trailing minute
+inline constexpr std::size_t kRateBuckets = 60;
+
+// Event counter that reports how often something happened in the last
+// minute. Events are counted into per-second buckets and the rate is summed
+// as of the moment it is read, so seconds in which nothing was recorded
+// count as zero: a loop that stayed paused reads close to zero when it next
+// wakes.
+struct RateCounter {
+  std::uint64_t total;
+  std::array<std::uint64_t, kRateBuckets> buckets;
+  // Second (since the clock's epoch) of the newest bucket
+  std::int64_t last_second;
+};
+
+// Diagnostics collected by the event loop when started with --stats
+struct LoopStats {
+  RateCounter wakeups;
+  // Keys handled, and the most drained in a single wakeup
+  RateCounter keys;
+  std::uint64_t max_keys_per_wakeup;
+  RateCounter frames;
+  RateCounter allocations;
+  std::uint64_t allocations_seen;
+  RateCounter writes;
+  RateCounter bytes;
+  OutputStats output_seen;
+  // When the loop last woke; the display reads rates as of then
+  Clock::time_point last_wakeup;
+};
+
+void stats_record_wakeup(LoopStats& stats, Clock::time_point now,
+                         std::uint64_t keys);
+void stats_record_frame(LoopStats& stats, Clock::time_point now,
+                        const OutputStats* output);
+
+void rate_record(RateCounter& counter, Clock::time_point now,
+                 std::uint64_t amount = 1);
+std::uint64_t rate_per_minute(const RateCounter& counter,
+                              Clock::time_point now);
@@ -0,0 +1,200 @@
+#include "status_file.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "session.h"
+#include "timer.h"
+
+using namespace std::chrono;
+
+namespace {
+// A write takes nanoseconds, so a reader that keeps losing the race is
+// looking at a publisher that died mid-write
+constexpr int kMaxReadAttempts = 64;
+
+StatusRecord* map_record(int fd, int protection) {
+  void* address = mmap(nullptr, sizeof(StatusRecord), protection, MAP_SHARED,
+                       fd, 0);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) // mapping
+  return reinterpret_cast<StatusRecord*>(address);
+}
+
+void unmap_record(const StatusRecord* record) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // munmap API
+  munmap(const_cast<StatusRecord*>(record), sizeof(StatusRecord));
+}
+
+// Writer side of the seqlock: the odd sequence is ordered before the field
+// stores, and the even one after them
+void begin_write(StatusRecord& record) {
+  const std::uint64_t sequence =
+      record.sequence.load(std::memory_order_relaxed);
+  record.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void end_write(StatusRecord& record) {
+  record.sequence.store(record.sequence.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+}
+}  // namespace
+
+std::string status_default_path() {
+  if (const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+      runtime != nullptr && *runtime != '\0') {
+    return std::string(runtime) + "/pomodoro.status";
+  }
+  return "/tmp/pomodoro-" + std::to_string(getuid()) + ".status";
+}
+
+StatusPublisher::~StatusPublisher() {
+  if (record_ == nullptr) {
+    return;
+  }
+  begin_write(*record_);
+  record_->active.store(0, std::memory_order_relaxed);
+  end_write(*record_);
+  unmap_record(record_);
+  close(fd_);
+}
+
+// The fallback path is predictable and in a shared /tmp, so whatever is
+// found there must be our own regular file before it is truncated and
+// mapped: a symlink or another user's file planted there is refused
+bool StatusPublisher::open(const std::string& path, std::string& error) {
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0644);
+  if (fd_ < 0) {
+    error = "cannot open status file " + path + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat info{};
+  if (fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode) ||
+      info.st_uid != getuid()) {
+    error = "status file " + path + " is not a regular file owned by you";
+  } else if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+    error = "another timer is publishing to " + path;
+  } else if (ftruncate(fd_, sizeof(StatusRecord)) != 0 ||
+             (record_ = map_record(fd_, PROT_READ | PROT_WRITE)) == nullptr) {
+    error = "cannot map status file " + path + ": " + std::strerror(errno);
+  }
+  if (record_ == nullptr) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  // A previous publisher that died mid-write left the sequence odd
+  const std::uint64_t sequence =
+      record_->sequence.load(std::memory_order_relaxed);
+  if ((sequence & 1U) != 0) {
+    record_->sequence.store(sequence + 1, std::memory_order_release);
+  }
+  record_->magic.store(kStatusMagic, std::memory_order_relaxed);
+  record_->version.store(kStatusVersion, std::memory_order_relaxed);
+  return true;
+}
+
+void StatusPublisher::publish(const SessionState& session) {
+  if (record_ == nullptr) {
+    return;
+  }
+  begin_write(*record_);
+  record_->active.store(1, std::memory_order_relaxed);
+  record_->on_break.store(session.on_break ? 1 : 0, std::memory_order_relaxed);
+  record_->status.store(static_cast<std::uint64_t>(session.status),
+                        std::memory_order_relaxed);
+  record_->counting.store(session.tick.counting ? 1 : 0,
+                          std::memory_order_relaxed);
+  record_->total_s.store(session.tick.total.count(),
+                         std::memory_order_relaxed);
+  record_->remaining_ns.store(
+      duration_cast<nanoseconds>(session.tick.remaining).count(),
+      std::memory_order_relaxed);
+  record_->deadline_ns.store(
+      duration_cast<nanoseconds>(session.tick.deadline.time_since_epoch())
+          .count(),
+      std::memory_order_relaxed);
+  end_write(*record_);
+}
+
+StatusReader::~StatusReader() {
+  if (record_ != nullptr) {
+    unmap_record(record_);
+  }
+}
+
+// Non-blocking so a FIFO at the path cannot hang a status bar in open()
+bool StatusReader::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info{};
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(StatusRecord)) {
+    record_ = map_record(fd, PROT_READ);
+  }
+  close(fd);
+  return record_ != nullptr;
+}
+
+// Reader side of the seqlock: the copy stands if the sequence was even and
+// unchanged around it
+bool StatusReader::read(Clock::time_point now,
+                        StatusSnapshot& snapshot) const {
+  if (record_ == nullptr) {
+    return false;
+  }
+  const StatusRecord& record = *record_;
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const std::uint64_t before =
+        record.sequence.load(std::memory_order_acquire);
+    if ((before & 1U) != 0) {
+      continue;
+    }
+    const std::uint32_t magic = record.magic.load(std::memory_order_relaxed);
+    const std::uint32_t version =
+        record.version.load(std::memory_order_relaxed);
+    const std::uint64_t active = record.active.load(std::memory_order_relaxed);
+    const std::uint64_t on_break =
+        record.on_break.load(std::memory_order_relaxed);
+    const std::uint64_t status = record.status.load(std::memory_order_relaxed);
+    const std::uint64_t counting =
+        record.counting.load(std::memory_order_relaxed);
+    const std::int64_t total = record.total_s.load(std::memory_order_relaxed);
+    const std::int64_t remaining =
+        record.remaining_ns.load(std::memory_order_relaxed);
+    const std::int64_t deadline =
+        record.deadline_ns.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record.sequence.load(std::memory_order_relaxed) != before) {
+      continue;
+    }
+    if (magic != kStatusMagic || version != kStatusVersion ||
+        status >= kSessionStatusText.size()) {
+      return false;
+    }
+    TimerTickState tick{seconds(total), nanoseconds(remaining),
+                        Clock::time_point(nanoseconds(deadline)),
+                        counting != 0};
+    snapshot = {active != 0,   on_break != 0,
+                static_cast<SessionStatus>(status), counting != 0,
+                seconds(total), timer_remaining(tick, now)};
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "clock.h"
+#include "session.h"
+
+// Live session status in a small shared file for status bars (tmux,
+// polybar). The running timer maps it read-write and publishes on every
+// state change; readers map it read-only and copy a consistent snapshot out
+// under a sequence lock, which costs a handful of loads and no system calls
+// after the initial mmap. The record holds the countdown's deadline on the
+// system-wide steady clock rather than the time left, so the publisher
+// never has to wake just to keep it current.
+//
+// The file is one StatusRecord and its layout is the format other programs
+// may read directly: fixed-width fields at fixed offsets, in host byte
+// order (the file never leaves the machine).
+//
+//   offset size  field
+//        0    4  magic         kStatusMagic
+//        4    4  version       kStatusVersion; any change bumps it
+//        8    8  sequence      odd while the publisher is writing
+//       16    8  active        0 once the publishing timer has exited
+//       24    8  on_break      1 during a break
+//       32    8  status        SessionStatus, 0 to 6: Stopped, Running,
+//                              Paused, Break Ready, Break Running,
+//                              Break Paused, Break Stopped
+//       40    8  counting      1 while the countdown runs
+//       48    8  total_s       length of the phase, seconds (signed)
+//       56    8  remaining_ns  time left while not counting (signed)
+//       64    8  deadline_ns   end of the countdown while counting, on
+//                              CLOCK_MONOTONIC, nanoseconds (signed)
+//
+// To read it: load sequence and retry while it is odd, copy the fields,
+// then load sequence again and retry if it changed. Time left while
+// counting is deadline_ns minus the current CLOCK_MONOTONIC reading.
+
+inline constexpr std::uint32_t kStatusMagic = 0x504f4d53;  // "POMS"
+inline constexpr std::uint32_t kStatusVersion = 1;
+
+// Every field is a lock-free atomic, so the record can be shared between
+// processes and the seqlock's data reads are not data races
+struct StatusRecord {
+  std::atomic<std::uint32_t> magic;
+  std::atomic<std::uint32_t> version;
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::uint64_t> active;
+  std::atomic<std::uint64_t> on_break;
+  std::atomic<std::uint64_t> status;
+  std::atomic<std::uint64_t> counting;
+  std::atomic<std::int64_t> total_s;
+  std::atomic<std::int64_t> remaining_ns;
+  std::atomic<std::int64_t> deadline_ns;
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic<std::int64_t>::is_always_lock_free);
+static_assert(std::is_standard_layout_v<StatusRecord>);
+// The documented offsets
+static_assert(offsetof(StatusRecord, version) == 4);
+static_assert(offsetof(StatusRecord, sequence) == 8);
+static_assert(offsetof(StatusRecord, status) == 32);
+static_assert(offsetof(StatusRecord, deadline_ns) == 64);
+static_assert(sizeof(StatusRecord) == 72);
+// The status field's values are part of the format
+static_assert(static_cast<int>(SessionStatus::kBreakReady) == 3 &&
+              static_cast<int>(SessionStatus::kBreakStopped) == 6);
+
+// A reader's copy of the record, with the time left worked out for now
+struct StatusSnapshot {
+  // False once the publishing timer has exited
+  bool active;
+  bool on_break;
+  SessionStatus status;
+  bool counting;
+  std::chrono::seconds total;
+  Clock::duration remaining;
+};
+
+// $XDG_RUNTIME_DIR/pomodoro.status, falling back to
+// /tmp/pomodoro-<uid>.status
+std::string status_default_path();
+
+// The single writer of a status file, guarded by an exclusive flock held
+// while it is open. Publishing through a publisher that failed to open does
+// nothing, so callers need not check.
+class StatusPublisher {
+ public:
+  StatusPublisher() = default;
+  StatusPublisher(const StatusPublisher&) = delete;
+  StatusPublisher& operator=(const StatusPublisher&) = delete;
+  StatusPublisher(StatusPublisher&&) = delete;
+  StatusPublisher& operator=(StatusPublisher&&) = delete;
+  // Marks the record inactive before letting go of it
+  ~StatusPublisher();
+
+  // Creates or takes over the file at path; fails if another timer is
+  // publishing to it
+  bool open(const std::string& path, std::string& error);
+  void publish(const SessionState& session);
+
+ private:
+  StatusRecord* record_ = nullptr;
+  int fd_ = -1;
+};
+
+class StatusReader {
+ public:
+  StatusReader() = default;
+  StatusReader(const StatusReader&) = delete;
+  StatusReader& operator=(const StatusReader&) = delete;
+  StatusReader(StatusReader&&) = delete;
+  StatusReader& operator=(StatusReader&&) = delete;
+  ~StatusReader();
+
+  // Maps the file at path; the descriptor is closed straight away
+  bool open(const std::string& path);
+  // Takes a consistent snapshot; false if the file is not a status record
+  // or the publisher kept writing through every attempt
+  bool read(Clock::time_point now, StatusSnapshot& snapshot) const;
+
+ private:
+  const StatusRecord* record_ = nullptr;
+};
@@ -0,0 +1,66 @@
+#include "timer.h"
+
+#include <chrono>
+
+using namespace std::chrono;
+
+// Creates a stopped timer holding the full session length
+TimerTickState timer_make(seconds total) {
+  return {total, total, steady_clock::time_point{}, false};
+}
+
+// Starts or resumes the countdown by anchoring the deadline to now
+void timer_start(TimerTickState& state, steady_clock::time_point now) {
+  if (state.counting) {
+    return;
+  }
+  state.deadline = now + state.remaining;
+  state.counting = true;
+}
+
+// Freezes the remaining time; a later timer_start shifts the deadline forward
+void timer_pause(TimerTickState& state, steady_clock::time_point now) {
+  if (!state.counting) {
+    return;
+  }
+  state.remaining = timer_remaining(state, now);
+  state.counting = false;
+}
+
+// Returns the time left, clamped at zero
+steady_clock::duration timer_remaining(const TimerTickState& state,
+                                       steady_clock::time_point now) {
+  if (!state.counting) {
+    return state.remaining;
+  }
+  if (now >= state.deadline) {
+    return steady_clock::duration::zero();
+  }
+  return state.deadline - now;
+}
+
+// Returns the whole seconds left, rounded up so the display only reaches 00:00
+// when the session is actually over
+seconds timer_remaining_seconds(const TimerTickState& state,
+                                steady_clock::time_point now) {
+  return ceil<seconds>(timer_remaining(state, now));
+}
+
+// Returns true if the timer has finished, false otherwise
+bool timer_tick(const TimerTickState& state, steady_clock::time_point now) {
+  return timer_remaining(state, now) == steady_clock::duration::zero();
+}
+
+// Returns the instant the displayed (rounded-up) second next changes, or
+// time_point::max() while the timer is not counting down
+steady_clock::time_point timer_next_change(const TimerTickState& state,
+                                           steady_clock::time_point now) {
+  if (!state.counting) {
+    return steady_clock::time_point::max();
+  }
+  const auto remaining = timer_remaining(state, now);
+  if (remaining == steady_clock::duration::zero()) {
+    return now;
+  }
+  return state.deadline - (ceil<seconds>(remaining) - seconds(1));
+}
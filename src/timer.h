@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <limits>
+
+// Session lengths and display values are whole seconds; both they and the
+// steady_clock ticks must be 64-bit so multi-day sessions cannot overflow.
+static_assert(std::numeric_limits<std::chrono::seconds::rep>::digits >= 63);
+static_assert(
+    std::numeric_limits<std::chrono::steady_clock::rep>::digits >= 63);
+
+// Deadline-based countdown state. While counting down the absolute deadline
+// is authoritative, so time spent in getch/draw/sleep is never lost; while
+// stopped or paused the frozen remaining duration is authoritative.
+struct TimerTickState {
+  std::chrono::seconds total;
+  std::chrono::steady_clock::duration remaining;
+  std::chrono::steady_clock::time_point deadline;
+  bool counting;
+};
+
+TimerTickState timer_make(std::chrono::seconds total);
+void timer_start(TimerTickState& state,
+                 std::chrono::steady_clock::time_point now);
+void timer_pause(TimerTickState& state,
+                 std::chrono::steady_clock::time_point now);
+std::chrono::steady_clock::duration timer_remaining(
+    const TimerTickState& state, std::chrono::steady_clock::time_point now);
+std::chrono::seconds timer_remaining_seconds(
+    const TimerTickState& state, std::chrono::steady_clock::time_point now);
+bool timer_tick(const TimerTickState& state,
+                std::chrono::steady_clock::time_point now);
+std::chrono::steady_clock::time_point timer_next_change(
+    const TimerTickState& state, std::chrono::steady_clock::time_point now);
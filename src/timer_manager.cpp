@@ -0,0 +1,104 @@
+#include "timer_manager.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "session.h"
+
+TimerManager::TimerManager(Clock::time_point start) : wheel_(start) {}
+
+TimerId TimerManager::open(std::string_view name, const SessionTime& pomodoro,
+                           const SessionTime& brk) {
+  if (const auto found = by_name_.find(name); found != by_name_.end()) {
+    return found->second;
+  }
+  Entry entry{std::string(name), pomodoro, brk, session_make(pomodoro)};
+  TimerId id = 0;
+  if (!free_.empty()) {
+    id = free_.back();
+    free_.pop_back();
+    entries_[id] = std::move(entry);
+  } else {
+    id = static_cast<TimerId>(entries_.size());
+    entries_.push_back(std::move(entry));
+  }
+  by_name_.emplace(name, id);
+  return id;
+}
+
+bool TimerManager::find(std::string_view name, TimerId& id) const {
+  const auto found = by_name_.find(name);
+  if (found == by_name_.end()) {
+    return false;
+  }
+  id = found->second;
+  return true;
+}
+
+void TimerManager::remove(TimerId id) {
+  wheel_.cancel(id);
+  by_name_.erase(entries_[id].name);
+  entries_[id] = Entry();
+  free_.push_back(id);
+}
+
+void TimerManager::restore(TimerId id, const SessionTime& pomodoro,
+                           const SessionTime& brk,
+                           const SessionState& session) {
+  Entry& entry = entries_[id];
+  entry.pomodoro = pomodoro;
+  entry.brk = brk;
+  entry.session = session;
+  reschedule(id);
+}
+
+void TimerManager::apply(TimerId id, SessionCommand command,
+                         Clock::time_point now) {
+  Entry& entry = entries_[id];
+  session_apply(entry.session, command, entry.pomodoro, entry.brk, now);
+  reschedule(id);
+}
+
+// The wheel rounds deadlines up to whole ticks, so every session it reports
+// has really finished; the next phase waits to be started
+void TimerManager::advance(Clock::time_point now,
+                           std::vector<TimerId>& changed) {
+  expired_.clear();
+  wheel_.advance(now, expired_);
+  for (const TimerId id : expired_) {
+    Entry& entry = entries_[id];
+    session_finish(entry.session, entry.pomodoro, entry.brk);
+    changed.push_back(id);
+  }
+}
+
+Clock::time_point TimerManager::next_deadline() const {
+  return wheel_.next_deadline();
+}
+
+const SessionState& TimerManager::session(TimerId id) const {
+  return entries_[id].session;
+}
+
+const SessionTime& TimerManager::pomodoro(TimerId id) const {
+  return entries_[id].pomodoro;
+}
+
+const SessionTime& TimerManager::brk(TimerId id) const {
+  return entries_[id].brk;
+}
+
+const std::string& TimerManager::name(TimerId id) const {
+  return entries_[id].name;
+}
+
+void TimerManager::reschedule(TimerId id) {
+  const SessionState& session = entries_[id].session;
+  if (session_counting(session)) {
+    wheel_.schedule(id, session.tick.deadline);
+  } else {
+    wheel_.cancel(id);
+  }
+}
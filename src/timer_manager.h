@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "clock.h"
+#include "session.h"
+#include "timer_wheel.h"
+
+// Longest timer name, in bytes
+inline constexpr std::size_t kMaxTimerNameLength = 32;
+
+// Many independent pomodoro sessions in one process (one per person or
+// desk), each known by a name. Each session follows the usual rules
+// (session_apply, session_finish); the manager only tracks when each
+// running phase ends, in a TimerWheel, so finding the finished phases costs
+// the same whether ten or a million sessions are running.
+class TimerManager {
+ public:
+  explicit TimerManager(Clock::time_point start);
+
+  // Returns the id of the session called name, creating a stopped one with
+  // the given lengths if there is none. Ids are reused after remove().
+  TimerId open(std::string_view name, const SessionTime& pomodoro,
+               const SessionTime& brk);
+  // Looks up a session by name
+  [[nodiscard]] bool find(std::string_view name, TimerId& id) const;
+  void remove(TimerId id);
+
+  // Replaces the state of a session, as when resuming from a checkpoint
+  void restore(TimerId id, const SessionTime& pomodoro, const SessionTime& brk,
+               const SessionState& session);
+  void apply(TimerId id, SessionCommand command, Clock::time_point now);
+  // Moves every session whose phase has ended by now on to its next phase
+  // and appends their ids to changed
+  void advance(Clock::time_point now, std::vector<TimerId>& changed);
+  // When advance() next has work, or time_point::max() if nothing runs
+  [[nodiscard]] Clock::time_point next_deadline() const;
+
+  [[nodiscard]] const SessionState& session(TimerId id) const;
+  [[nodiscard]] const SessionTime& pomodoro(TimerId id) const;
+  [[nodiscard]] const SessionTime& brk(TimerId id) const;
+  [[nodiscard]] const std::string& name(TimerId id) const;
+  [[nodiscard]] std::size_t size() const { return by_name_.size(); }
+
+ private:
+  struct Entry {
+    std::string name;
+    SessionTime pomodoro;
+    SessionTime brk;
+    SessionState session;
+  };
+
+  // Lets by_name_ be searched with a string_view
+  struct NameHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view name) const {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+  // Keeps the wheel in step with whether the session is counting down
+  void reschedule(TimerId id);
+
+  std::vector<Entry> entries_;
+  std::vector<TimerId> free_;
+  std::unordered_map<std::string, TimerId, NameHash, std::equal_to<>>
+      by_name_;
+  TimerWheel wheel_;
+  // Scratch list of expired ids, kept to avoid reallocating
+  std::vector<TimerId> expired_;
+};
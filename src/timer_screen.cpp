@@ -0,0 +1,85 @@
+#include "timer_screen.h"
+
+#include <ncurses.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "alloc_count.h"
+#include "pomodoro.h"
+#include "shutdown.h"
+
+namespace {
+// Upper bound on keys handled between two renders
+constexpr std::uint64_t kMaxKeysPerWakeup = 4096;
+}  // namespace
+
+TimerScreen::TimerScreen(Clock& clock, Screen& screen, LoopStats* stats)
+    : clock_(clock), screen_(screen), stats_(stats) {}
+
+void TimerScreen::start(const SessionState& session) {
+  shown_ = timer_view(session.tick, clock_.now(), screen_.layout().bar_steps);
+  draw(screen_, shown_, session.status, stats_);
+  if (stats_ != nullptr) {
+    // Only allocations and output made by the loop itself are of interest
+    stats_->allocations_seen = allocation_count();
+    if (const OutputStats* output = screen_.renderer().output_stats()) {
+      stats_->output_seen = *output;
+    }
+  }
+}
+
+void TimerScreen::wait(const SessionState& session, int extra_fd) {
+  const auto wake_at = session_counting(session)
+                           ? next_frame_at(session.tick, clock_.now(),
+                                           screen_.layout().bar_steps)
+                           : Clock::time_point::max();
+  const std::array<int, 3> fds = {screen_.input_fd(), shutdown_fd(),
+                                  extra_fd};
+  const std::size_t count = extra_fd >= 0 ? fds.size() : fds.size() - 1;
+  readable_ = clock_.wait_readable(std::span(fds.data(), count), wake_at);
+  resized_ = false;
+  keys_ = 0;
+}
+
+bool TimerScreen::next_action(Action& action) {
+  if (!readable_ || keys_ >= kMaxKeysPerWakeup) {
+    return false;
+  }
+  const int key_code = screen_.read_key(false);
+  if (key_code == ERR) {
+    return false;
+  }
+  ++keys_;
+  action = screen_.action(KeyContext::kTimer, key_code);
+  resized_ = resized_ || action == Action::kResize;
+  return true;
+}
+
+void TimerScreen::record_wakeup() {
+  if (stats_ != nullptr) {
+    stats_record_wakeup(*stats_, clock_.now(), keys_);
+  }
+}
+
+// A change of state or size repaints the whole screen; a countdown step only
+// the clock rows. --stats repaints in full so its figures stay current.
+void TimerScreen::render(const SessionState& session, bool dirty) {
+  dirty = dirty || resized_;
+  const TimerView view =
+      timer_view(session.tick, clock_.now(), screen_.layout().bar_steps);
+  if (!dirty && view == shown_) {
+    return;
+  }
+  shown_ = view;
+  if (dirty || stats_ != nullptr) {
+    draw(screen_, shown_, session.status, stats_);
+  } else {
+    draw_clock(screen_, shown_);
+  }
+  if (stats_ != nullptr) {
+    stats_record_frame(*stats_, clock_.now(),
+                       screen_.renderer().output_stats());
+  }
+}
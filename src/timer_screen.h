@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+#include "clock.h"
+#include "frame.h"
+#include "keymap.h"
+#include "screen.h"
+#include "session.h"
+#include "stats.h"
+
+// The wait, drain and render cycle of a timer screen, shared by the local
+// timer and a TUI attached to the daemon. Each wakeup is:
+//
+//   timer_screen.wait(session, extra_fd);
+//   for (Action action{}; timer_screen.next_action(action);) { ... }
+//   timer_screen.record_wakeup();
+//   ... apply what happened to session ...
+//   timer_screen.render(session, dirty);
+//
+// and only what an action does, and where the session comes from, differs
+// between the loops.
+class TimerScreen {
+ public:
+  TimerScreen(Clock& clock, Screen& screen, LoopStats* stats);
+
+  // Draws the first frame; allocations and output are counted from here
+  void start(const SessionState& session);
+  // Blocks until a key, a shutdown signal or extra_fd (when not -1) is
+  // readable, or until the next displayed change of a counting session. No
+  // deadline while stopped or paused, so the process sleeps until a key or
+  // SIGWINCH (delivered as KEY_RESIZE) wakes it.
+  void wait(const SessionState& session, int extra_fd = -1);
+  // Takes the next key buffered since wait() as a timer-screen action.
+  // Draining every key before rendering makes a burst (paste, key repeat,
+  // injected input) cost one frame instead of one per key; the cap keeps an
+  // endless input stream from starving the display.
+  bool next_action(Action& action);
+  // Counts the wakeup and the keys it handled in --stats
+  void record_wakeup();
+  // Redraws when something visible changed (dirty, a resize, or the view),
+  // independent of why the loop woke up
+  void render(const SessionState& session, bool dirty);
+
+ private:
+  Clock& clock_;
+  Screen& screen_;
+  LoopStats* stats_;
+  TimerView shown_{};
+  bool readable_ = false;
+  bool resized_ = false;
+  std::uint64_t keys_ = 0;
+};
@@ -0,0 +1,188 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+// Ticks are counted from the wheel's start; deadlines round up so a timer
+// never fires early
+std::uint64_t ticks_until(Clock::time_point start, Clock::time_point deadline) {
+  if (deadline <= start) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(
+      ceil<TimerWheel::duration>(deadline - start).count());
+}
+}  // namespace
+
+TimerWheel::TimerWheel(Clock::time_point start) : start_(start) {
+  heads_.fill(kNil);
+}
+
+void TimerWheel::schedule(TimerId id, Clock::time_point deadline) {
+  if (id >= nodes_.size()) {
+    nodes_.resize(static_cast<std::size_t>(id) + 1,
+                  Node{0, kNil, kNil, kUnscheduled});
+  }
+  if (nodes_[id].list != kUnscheduled) {
+    unlink(id);
+  }
+  nodes_[id].expiry = ticks_until(start_, deadline);
+  file(id);
+}
+
+void TimerWheel::cancel(TimerId id) {
+  if (scheduled(id)) {
+    unlink(id);
+  }
+}
+
+bool TimerWheel::scheduled(TimerId id) const {
+  return id < nodes_.size() && nodes_[id].list != kUnscheduled;
+}
+
+// Each due list is emptied as the wheel reaches it: timers that have expired
+// are reported, the rest are filed again one or more levels further down
+void TimerWheel::advance(Clock::time_point now,
+                         std::vector<TimerId>& expired) {
+  // Only ticks that have fully elapsed count, so this rounds down
+  const std::uint64_t elapsed =
+      now <= start_ ? 0
+                    : static_cast<std::uint64_t>(
+                          floor<duration>(now - start_).count());
+  const std::uint64_t target = std::max(elapsed, now_tick_);
+  while (true) {
+    const std::uint64_t due = next_due_tick();
+    if (due > target) {
+      break;
+    }
+    now_tick_ = due;
+    take(kDueList);
+    for (unsigned level = 0; level < kLevels; ++level) {
+      const unsigned shift = level * kSlotBits;
+      if ((now_tick_ & ((std::uint64_t{1} << shift) - 1)) == 0) {
+        take((level * kSlots) + ((now_tick_ >> shift) & (kSlots - 1)));
+      }
+    }
+    if ((now_tick_ & ((std::uint64_t{1} << (kLevels * kSlotBits)) - 1)) ==
+        0) {
+      take(kOverflowList);
+    }
+    for (const TimerId id : draining_) {
+      if (nodes_[id].expiry <= now_tick_) {
+        expired.push_back(id);
+      } else {
+        file(id);
+      }
+    }
+    draining_.clear();
+  }
+  now_tick_ = target;
+}
+
+Clock::time_point TimerWheel::next_deadline() const {
+  const std::uint64_t tick = next_due_tick();
+  if (tick == std::numeric_limits<std::uint64_t>::max()) {
+    return Clock::time_point::max();
+  }
+  return start_ + duration(static_cast<duration::rep>(tick));
+}
+
+void TimerWheel::link(TimerId id, std::size_t list) {
+  Node& node = nodes_[id];
+  node.list = static_cast<std::uint16_t>(list);
+  node.prev = kNil;
+  node.next = heads_[list];
+  if (node.next != kNil) {
+    nodes_[node.next].prev = id;
+  }
+  heads_[list] = id;
+  if (list < kDueList) {
+    occupied_[list / kSlots] |= std::uint64_t{1} << (list % kSlots);
+  }
+}
+
+void TimerWheel::unlink(TimerId id) {
+  Node& node = nodes_[id];
+  const std::size_t list = node.list;
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    heads_[list] = node.next;
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  if (list < kDueList && heads_[list] == kNil) {
+    occupied_[list / kSlots] &= ~(std::uint64_t{1} << (list % kSlots));
+  }
+  node.list = kUnscheduled;
+}
+
+void TimerWheel::take(std::size_t list) {
+  for (std::uint32_t id = heads_[list]; id != kNil; id = nodes_[id].next) {
+    nodes_[id].list = kUnscheduled;
+    draining_.push_back(id);
+  }
+  heads_[list] = kNil;
+  if (list < kDueList) {
+    occupied_[list / kSlots] &= ~(std::uint64_t{1} << (list % kSlots));
+  }
+}
+
+// A timer is filed at the highest level where its expiry and the current
+// tick differ, in the slot of its digit there. All timers in one slot share
+// the digits above it, so the slot comes due when the current tick reaches
+// that digit with every digit below it zero.
+void TimerWheel::file(TimerId id) {
+  const std::uint64_t expiry = nodes_[id].expiry;
+  if (expiry <= now_tick_) {
+    link(id, kDueList);
+    return;
+  }
+  const auto level =
+      static_cast<unsigned>(std::bit_width(expiry ^ now_tick_) - 1) /
+      kSlotBits;
+  if (level >= kLevels) {
+    link(id, kOverflowList);
+    return;
+  }
+  const auto slot = (expiry >> (level * kSlotBits)) & (kSlots - 1);
+  link(id, (level * kSlots) + slot);
+}
+
+// Occupied slots always lie ahead of the current tick's digit on their
+// level, and any slot on a lower level comes due before one on a higher
+// level, so the first occupied level decides
+std::uint64_t TimerWheel::next_due_tick() const {
+  if (heads_[kDueList] != kNil) {
+    return now_tick_;
+  }
+  for (unsigned level = 0; level < kLevels; ++level) {
+    const unsigned shift = level * kSlotBits;
+    const auto digit = static_cast<unsigned>((now_tick_ >> shift) &
+                                             (kSlots - 1));
+    const std::uint64_t ahead =
+        digit + 1 == kSlots
+            ? 0
+            : (occupied_[level] >> (digit + 1)) << (digit + 1);
+    if (ahead != 0) {
+      const unsigned block = shift + kSlotBits;
+      const std::uint64_t base = (now_tick_ >> block) << block;
+      return base + (static_cast<std::uint64_t>(std::countr_zero(ahead))
+                     << shift);
+    }
+  }
+  if (heads_[kOverflowList] != kNil) {
+    constexpr unsigned kSpan = kLevels * kSlotBits;
+    return ((now_tick_ >> kSpan) + 1) << kSpan;
+  }
+  return std::numeric_limits<std::uint64_t>::max();
+}
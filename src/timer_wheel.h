@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "clock.h"
+
+// Dense timer handle, chosen by the owner of the wheel
+using TimerId = std::uint32_t;
+
+// Hierarchical timing wheel: kLevels wheels of 64 slots, each slot of level
+// L spanning 64^L ticks of one millisecond, which together cover about 795
+// days (later deadlines wait in an overflow list and are re-filed as time
+// approaches them). Timers live in intrusive lists over a node array indexed
+// by id, so schedule and cancel are O(1) and never allocate once the array
+// has grown to the largest id. advance() jumps straight to the next occupied
+// slot using a per-level occupancy bitmap and re-files a slot's timers one
+// level down as it comes due, so each timer is touched at most once per
+// level: the cost of a tick does not depend on how many timers are pending.
+class TimerWheel {
+ public:
+  using duration = std::chrono::milliseconds;
+  static constexpr duration kTick = duration(1);
+
+  explicit TimerWheel(Clock::time_point start);
+
+  // (Re)schedules id to expire at deadline; a deadline that has already
+  // passed expires on the next advance()
+  void schedule(TimerId id, Clock::time_point deadline);
+  void cancel(TimerId id);
+  [[nodiscard]] bool scheduled(TimerId id) const;
+  // Moves the wheel to now and appends every timer due by then to expired;
+  // expired timers are no longer scheduled
+  void advance(Clock::time_point now, std::vector<TimerId>& expired);
+  // When the next timer may be due, or time_point::max() when none is
+  // scheduled. Can be early (a slot that only re-files timers), never late.
+  [[nodiscard]] Clock::time_point next_deadline() const;
+
+ private:
+  static constexpr unsigned kSlotBits = 6;
+  static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+  static constexpr unsigned kLevels = 6;
+  // Lists: the wheel slots, then already-due timers, then the overflow
+  static constexpr std::size_t kDueList = kLevels * kSlots;
+  static constexpr std::size_t kOverflowList = kDueList + 1;
+  static constexpr std::size_t kListCount = kOverflowList + 1;
+  static constexpr std::uint32_t kNil =
+      std::numeric_limits<std::uint32_t>::max();
+  static constexpr std::uint16_t kUnscheduled =
+      std::numeric_limits<std::uint16_t>::max();
+
+  struct Node {
+    std::uint64_t expiry;
+    std::uint32_t prev;
+    std::uint32_t next;
+    std::uint16_t list;
+  };
+
+  void link(TimerId id, std::size_t list);
+  void unlink(TimerId id);
+  // Empties list into draining_, leaving its timers unscheduled
+  void take(std::size_t list);
+  // Files id by its expiry relative to the current tick
+  void file(TimerId id);
+  // Tick at which the next non-empty list comes due, or max() if none
+  [[nodiscard]] std::uint64_t next_due_tick() const;
+
+  Clock::time_point start_;
+  std::uint64_t now_tick_ = 0;
+  std::vector<Node> nodes_;
+  std::array<std::uint32_t, kListCount> heads_{};
+  // Bit s of occupied_[L] is set while slot s of level L is non-empty
+  std::array<std::uint64_t, kLevels> occupied_{};
+  // Scratch list for the slot being emptied, kept to avoid reallocating
+  std::vector<TimerId> draining_;
+};
@@ -0,0 +1,148 @@
+#include "tty_input.h"
+
+#include <ncurses.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace {
+constexpr int kEscapeKey = 27;
+constexpr int kDeleteKey = 127;
+constexpr int kNoByte = -1;
+constexpr int kEndOfInput = -2;
+// How long to wait for the rest of an escape sequence, like curses ESCDELAY
+constexpr int kEscapeDelayMs = 25;
+// Byte classes of an ECMA-48 control sequence
+constexpr int kFirstParameterByte = 0x30;
+constexpr int kLastParameterByte = 0x3f;
+constexpr int kFirstIntermediateByte = 0x20;
+constexpr int kLastIntermediateByte = 0x2f;
+constexpr int kFirstFinalByte = 0x40;
+constexpr int kLastFinalByte = 0x7e;
+// Larger parameters name no key; stops the value overflowing
+constexpr int kMaxParameter = 1000;
+}  // namespace
+
+TtyInput::TtyInput(int fd) : fd_(fd) {
+  if (isatty(fd_) != 0 && tcgetattr(fd_, &saved_termios_) == 0) {
+    termios_saved_ = true;
+    termios raw = saved_termios_;
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+    raw.c_iflag &= ~static_cast<tcflag_t>(ICRNL | IXON);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(fd_, TCSAFLUSH, &raw);
+  }
+}
+
+TtyInput::~TtyInput() {
+  if (termios_saved_) {
+    tcsetattr(fd_, TCSAFLUSH, &saved_termios_);
+  }
+}
+
+// Decodes one key, mapping common escape sequences to curses key codes
+int TtyInput::read_key(bool block) {
+  if (closed_) {
+    return KEY_EXIT;
+  }
+  const int byte = read_byte(block ? -1 : 0);
+  if (byte == kEndOfInput) {
+    return KEY_EXIT;
+  }
+  if (byte == kNoByte) {
+    return ERR;
+  }
+  if (byte == kEscapeKey) {
+    return read_escape_sequence();
+  }
+  if (byte == '\r') {
+    return '\n';
+  }
+  if (byte == kDeleteKey) {
+    return KEY_BACKSPACE;
+  }
+  return byte;
+}
+
+// Reads one byte, waiting at most timeout_ms (-1 blocks). Returns kNoByte
+// when nothing arrived (including a signal interrupting the wait) and
+// kEndOfInput once the descriptor reports end of file.
+int TtyInput::read_byte(int timeout_ms) {
+  pollfd pfd{fd_, POLLIN, 0};
+  if (poll(&pfd, 1, timeout_ms) <= 0) {
+    return kNoByte;
+  }
+  unsigned char byte = 0;
+  const ssize_t result = read(fd_, &byte, 1);
+  if (result == 0 || (result < 0 && errno != EINTR && errno != EAGAIN)) {
+    closed_ = true;
+    return kEndOfInput;
+  }
+  if (result < 0) {
+    return kNoByte;
+  }
+  return byte;
+}
+
+// Handles CSI (ESC [) and SS3 (ESC O) sequences; a lone ESC is returned as is.
+// The whole sequence is consumed, up to its final byte (0x40 to 0x7E), so
+// modified keys such as ESC[1;5A (Ctrl-Up) or ESC[5;2~ (Shift-PageUp) leave
+// nothing behind to be read as typed characters; they map as the plain key
+// named by the first parameter. A sequence cut short returns ERR.
+int TtyInput::read_escape_sequence() {
+  const int intro = read_byte(kEscapeDelayMs);
+  if (intro != '[' && intro != 'O') {
+    return kEscapeKey;
+  }
+  int param = 0;
+  bool first_param = true;
+  int byte = read_byte(kEscapeDelayMs);
+  // Parameter bytes (digits, ';', ':', '<' to '?') and intermediate bytes
+  while ((byte >= kFirstParameterByte && byte <= kLastParameterByte) ||
+         (byte >= kFirstIntermediateByte && byte <= kLastIntermediateByte)) {
+    if (byte == ';' || byte == ':') {
+      first_param = false;
+    } else if (first_param && byte >= '0' && byte <= '9' &&
+               param < kMaxParameter) {
+      param = (param * 10) + (byte - '0');
+    }
+    byte = read_byte(kEscapeDelayMs);
+  }
+  if (byte < kFirstFinalByte || byte > kLastFinalByte) {
+    return ERR;
+  }
+  switch (byte) {
+    case 'A':
+      return KEY_UP;
+    case 'B':
+      return KEY_DOWN;
+    case 'C':
+      return KEY_RIGHT;
+    case 'D':
+      return KEY_LEFT;
+    case 'H':
+      return KEY_HOME;
+    case 'F':
+      return KEY_END;
+    case '~':
+      switch (param) {
+        case 1:
+        case 7:
+          return KEY_HOME;
+        case 4:
+        case 8:
+          return KEY_END;
+        case 5:
+          return KEY_PPAGE;
+        case 6:
+          return KEY_NPAGE;
+        default:
+          return ERR;
+      }
+    default:
+      return ERR;
+  }
+}
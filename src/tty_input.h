@@ -0,0 +1,33 @@
+#pragma once
+
+#include <termios.h>
+#include <unistd.h>
+
+// Keyboard input read straight from a file descriptor, for the backends that
+// do not use curses. A tty is switched to non-canonical, no-echo mode for the
+// lifetime of the object; a pipe or file works too, which is how headless
+// runs are scripted. Escape sequences are decoded into curses key codes and
+// end of input is reported as KEY_EXIT.
+class TtyInput {
+ public:
+  explicit TtyInput(int fd = STDIN_FILENO);
+  TtyInput(const TtyInput&) = delete;
+  TtyInput& operator=(const TtyInput&) = delete;
+  TtyInput(TtyInput&&) = delete;
+  TtyInput& operator=(TtyInput&&) = delete;
+  ~TtyInput();
+
+  // Returns the next key, or ERR when block is false and none is pending
+  int read_key(bool block);
+  // Descriptor to poll, or -1 once input has ended (poll ignores it)
+  [[nodiscard]] int fd() const { return closed_ ? -1 : fd_; }
+
+ private:
+  int read_byte(int timeout_ms);
+  int read_escape_sequence();
+
+  int fd_;
+  termios saved_termios_{};
+  bool termios_saved_ = false;
+  bool closed_ = false;
+};
@@ -0,0 +1,109 @@
+#include "utf8.h"
+
+#include <langinfo.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace {
+constexpr char32_t kReplacement = 0xFFFD;
+constexpr char32_t kMaxCodePoint = 0x10FFFF;
+constexpr char32_t kFirstSurrogate = 0xD800;
+constexpr char32_t kLastSurrogate = 0xDFFF;
+constexpr unsigned char kContinuationMask = 0xC0;
+constexpr unsigned char kContinuationTag = 0x80;
+
+bool is_continuation(unsigned char byte) {
+  return (byte & kContinuationMask) == kContinuationTag;
+}
+}  // namespace
+
+// Validates as it decodes: leads that cannot start a sequence (0x80-0xC1,
+// 0xF5-0xFF), truncated sequences, overlong encodings, surrogates and code
+// points past U+10FFFF all give U+FFFD and consume only the first byte
+char32_t utf8_pop(std::string_view& text) {
+  const auto lead = static_cast<unsigned char>(text.front());
+  std::size_t length = 1;
+  char32_t code_point = lead;
+  char32_t minimum = 0;
+  if (lead < 0x80) {
+    text.remove_prefix(1);
+    return code_point;
+  }
+  if (lead >= 0xC2 && lead < 0xE0) {
+    length = 2;
+    code_point = lead & 0x1FU;
+    minimum = 0x80;
+  } else if (lead >= 0xE0 && lead < 0xF0) {
+    length = 3;
+    code_point = lead & 0x0FU;
+    minimum = 0x800;
+  } else if (lead >= 0xF0 && lead < 0xF5) {
+    length = 4;
+    code_point = lead & 0x07U;
+    minimum = 0x10000;
+  } else {
+    text.remove_prefix(1);
+    return kReplacement;
+  }
+  if (length > text.size()) {
+    text.remove_prefix(1);
+    return kReplacement;
+  }
+  for (std::size_t i = 1; i < length; ++i) {
+    const auto byte = static_cast<unsigned char>(text[i]);
+    if (!is_continuation(byte)) {
+      text.remove_prefix(1);
+      return kReplacement;
+    }
+    code_point = (code_point << 6U) | (byte & 0x3FU);
+  }
+  if (code_point < minimum || code_point > kMaxCodePoint ||
+      (code_point >= kFirstSurrogate && code_point <= kLastSurrogate)) {
+    text.remove_prefix(1);
+    return kReplacement;
+  }
+  text.remove_prefix(length);
+  return code_point;
+}
+
+void utf8_append(std::string& out, char32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0U | (code_point >> 6U));
+    out += static_cast<char>(0x80U | (code_point & 0x3FU));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0U | (code_point >> 12U));
+    out += static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (code_point & 0x3FU));
+  } else {
+    out += static_cast<char>(0xF0U | (code_point >> 18U));
+    out += static_cast<char>(0x80U | ((code_point >> 12U) & 0x3FU));
+    out += static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (code_point & 0x3FU));
+  }
+}
+
+// Counts what utf8_pop() would decode, so malformed bytes count as the
+// replacement cells the screen shows for them; plain ASCII takes a fast path
+std::size_t utf8_length(std::string_view text) {
+  std::size_t count = 0;
+  while (!text.empty()) {
+    if (static_cast<unsigned char>(text.front()) < 0x80) {
+      text.remove_prefix(1);
+    } else {
+      utf8_pop(text);
+    }
+    ++count;
+  }
+  return count;
+}
+
+bool utf8_locale() {
+  const char* codeset = nl_langinfo(CODESET);
+  return codeset != nullptr && (std::strcmp(codeset, "UTF-8") == 0 ||
+                                std::strcmp(codeset, "utf8") == 0);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Minimal UTF-8 helpers for the cell-based screen model. Every code point is
+// treated as one terminal column, which holds for the text this UI draws.
+
+// Decodes the code point at the front of text and removes it; malformed
+// bytes (invalid leads, truncated or overlong sequences, surrogates) decode as
+// U+FFFD one byte at a time
+char32_t utf8_pop(std::string_view& text);
+// Appends the UTF-8 encoding of code_point to out
+void utf8_append(std::string& out, char32_t code_point);
+// Number of code points (columns) in text, counting each malformed byte as
+// the one U+FFFD utf8_pop() turns it into
+std::size_t utf8_length(std::string_view text);
+// True when the current LC_CTYPE locale encodes text as UTF-8, i.e. the
+// terminal can be expected to show non-ASCII glyphs
+bool utf8_locale();
@@ -0,0 +1,64 @@
+#include "wakeup.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef POMODORO_USE_EVENTFD
+#include <sys/eventfd.h>
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifdef POMODORO_USE_EVENTFD
+Wakeup::Wakeup() : read_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+  write_fd_ = read_fd_;
+}
+
+Wakeup::~Wakeup() {
+  if (read_fd_ >= 0) {
+    close(read_fd_);
+  }
+}
+#else
+Wakeup::Wakeup() {
+  std::array<int, 2> ends{};
+  if (pipe(ends.data()) != 0) {
+    return;
+  }
+  for (const int end : ends) {
+    fcntl(end, F_SETFL, fcntl(end, F_GETFL) | O_NONBLOCK);
+    fcntl(end, F_SETFD, FD_CLOEXEC);
+  }
+  read_fd_ = ends[0];
+  write_fd_ = ends[1];
+}
+
+Wakeup::~Wakeup() {
+  if (read_fd_ >= 0) {
+    close(read_fd_);
+    close(write_fd_);
+  }
+}
+#endif
+
+void Wakeup::notify() {
+  if (pending_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  // An eventfd counter; any byte for the pipe. A full pipe is already
+  // readable, so a failed write loses nothing.
+  const std::uint64_t one = 1;
+  [[maybe_unused]] const ssize_t written =
+      write(write_fd_, &one, sizeof(one));
+}
+
+// The descriptor is drained before the flag drops, so a notify() after
+// that point writes again and the next wait returns at once; one before it
+// published its message before setting the flag this exchange reads
+void Wakeup::clear() {
+  std::array<std::uint8_t, sizeof(std::uint64_t)> buffer{};
+  while (read(read_fd_, buffer.data(), buffer.size()) > 0) {
+  }
+  pending_.exchange(false, std::memory_order_acq_rel);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+
+// Wakes a thread blocked in its Poller from another thread: an eventfd where
+// CMake finds one (Linux), a non-blocking pipe elsewhere. Notifications
+// between two clear() calls collapse into one write, so a busy producer
+// costs the consumer one wakeup, not one per message.
+class Wakeup {
+ public:
+  Wakeup();
+  Wakeup(const Wakeup&) = delete;
+  Wakeup& operator=(const Wakeup&) = delete;
+  Wakeup(Wakeup&&) = delete;
+  Wakeup& operator=(Wakeup&&) = delete;
+  ~Wakeup();
+
+  [[nodiscard]] bool ok() const { return read_fd_ >= 0; }
+  // Descriptor that becomes readable when notified
+  [[nodiscard]] int fd() const { return read_fd_; }
+  // Any thread: make fd() readable
+  void notify();
+  // Owner thread, before draining whatever the notifier published
+  void clear();
+
+ private:
+  int read_fd_ = -1;
+  int write_fd_ = -1;
+  std::atomic<bool> pending_{false};
+};
@@ -0,0 +1,76 @@
+#include "checkpoint.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "clock.h"
+#include "session.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr SessionTime kStudy{25min};
+constexpr SessionTime kBreak{5min};
+
+// A checkpoint path in a fresh directory that does not exist yet
+std::string fresh_path(const std::string& name) {
+  const std::filesystem::path dir =
+      std::filesystem::path(::testing::TempDir()) /
+      ("pomodoro-" + std::to_string(getpid())) / name;
+  std::filesystem::remove_all(dir);
+  return (dir / "checkpoint").string();
+}
+}  // namespace
+
+TEST(CheckpointTest, SecondOwnerIsRefusedUntilTheFirstLetsGo) {
+  const std::string path = fresh_path("lock");
+  {
+    CheckpointLock first;
+    ASSERT_TRUE(first.acquire(path));
+    // flock belongs to the open file description, so a second open in the
+    // same process contends exactly like another process would
+    CheckpointLock second;
+    EXPECT_FALSE(second.acquire(path));
+  }
+  CheckpointLock third;
+  EXPECT_TRUE(third.acquire(path));
+}
+
+TEST(CheckpointTest, LockDoesNotFollowSymlinks) {
+  const std::string path = fresh_path("symlink");
+  const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+  std::filesystem::create_directories(dir);
+  std::filesystem::create_symlink(dir / "elsewhere", path + ".lock");
+  CheckpointLock lock;
+  EXPECT_FALSE(lock.acquire(path));
+  EXPECT_FALSE(std::filesystem::exists(dir / "elsewhere"));
+}
+
+TEST(CheckpointTest, SavedSessionLoadsBack) {
+  const std::string path = fresh_path("round_trip");
+  VirtualClock clock;
+  SessionState session = session_make(kStudy);
+  session_apply(session, SessionCommand::kStartPause, kStudy, kBreak,
+                clock.now());
+  clock.advance(90s);
+  const auto wall = std::chrono::system_clock::now();
+  ASSERT_TRUE(checkpoint_save(
+      path, checkpoint_make(kStudy, kBreak, session, clock.now(), wall)));
+
+  Checkpoint loaded{};
+  ASSERT_TRUE(checkpoint_load(path, loaded));
+  EXPECT_EQ(loaded.study, kStudy.length);
+  EXPECT_EQ(loaded.brk, kBreak.length);
+  const SessionState restored =
+      checkpoint_restore(loaded, clock.now(), wall + 10s);
+  EXPECT_EQ(restored.status, SessionStatus::kRunning);
+  EXPECT_EQ(timer_remaining_seconds(restored.tick, clock.now()),
+            kStudy.length - 100s);
+
+  checkpoint_remove(path);
+  EXPECT_FALSE(checkpoint_load(path, loaded));
+}
@@ -0,0 +1,118 @@
+#include "daemon.h"
+
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "ipc.h"
+#include "session.h"
+#include "shutdown.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr std::size_t kShards = 4;
+constexpr int kReplyTimeoutMs = 5000;
+constexpr auto kStartupTimeout = 5s;
+
+struct TestClient {
+  int fd = -1;
+  FrameBuffer input;
+};
+
+int connect_when_ready(const std::string& path) {
+  const auto give_up = std::chrono::steady_clock::now() + kStartupTimeout;
+  int fd = ipc_connect(path);
+  while (fd < 0 && std::chrono::steady_clock::now() < give_up) {
+    std::this_thread::sleep_for(10ms);
+    fd = ipc_connect(path);
+  }
+  return fd;
+}
+
+bool send_bytes(int fd, std::span<const std::uint8_t> message,
+                std::size_t length) {
+  return length != 0 && ipc_send(fd, message.first(length));
+}
+
+bool attach(TestClient& client, const std::string& timer) {
+  std::array<std::uint8_t, kMaxMessageLength> message{};
+  return send_bytes(client.fd, message, ipc_encode_attach(timer, message));
+}
+
+bool command(TestClient& client, MessageType type) {
+  std::array<std::uint8_t, kMaxMessageLength> message{};
+  return send_bytes(client.fd, message, ipc_encode_command(type, message));
+}
+
+// Waits for the next state event; false on timeout or a lost connection
+bool next_event(TestClient& client, SessionEvent& event) {
+  while (true) {
+    Frame frame{};
+    while (client.input.next(frame)) {
+      if (ipc_decode_event(frame, event)) {
+        return true;
+      }
+    }
+    pollfd ready{client.fd, POLLIN, 0};
+    if (poll(&ready, 1, kReplyTimeoutMs) != 1 ||
+        client.input.fill(client.fd) == ReadResult::kClosed) {
+      return false;
+    }
+  }
+}
+}  // namespace
+
+// Timers spread over every shard by name, with clients handed from shard 0
+// to the owner; built with -DPOMODORO_SANITIZE=thread this is the test that
+// exercises the handoff queues and wakeups across threads
+TEST(DaemonTest, ShardedDaemonServesEveryTimerAndStopsOnSignal) {
+  const std::string path = ::testing::TempDir() + "pomodoro-daemon-" +
+                           std::to_string(getpid()) + ".sock";
+  shutdown_install();
+  SteadyClock clock;
+  const DaemonConfig config{path, "", "", {25min}, {5min}, kShards};
+  int status = -1;
+  std::thread daemon([&] { status = daemon_run(config, clock); });
+
+  // Two clients per timer, so every change is also fanned out
+  constexpr int kTimers = 16;
+  std::vector<TestClient> clients(kTimers * 2);
+  for (std::size_t index = 0; index < clients.size(); ++index) {
+    TestClient& client = clients[index];
+    client.fd = index == 0 ? connect_when_ready(path) : ipc_connect(path);
+    ASSERT_GE(client.fd, 0);
+    ASSERT_TRUE(attach(client, "timer-" + std::to_string(index % kTimers)));
+    SessionEvent event{};
+    ASSERT_TRUE(next_event(client, event)) << "client " << index;
+    EXPECT_EQ(event.status, SessionStatus::kStopped);
+  }
+  for (int timer = 0; timer < kTimers; ++timer) {
+    ASSERT_TRUE(command(clients[timer], MessageType::kStartPause));
+  }
+  for (std::size_t index = 0; index < clients.size(); ++index) {
+    SessionEvent event{};
+    ASSERT_TRUE(next_event(clients[index], event)) << "client " << index;
+    EXPECT_EQ(event.status, SessionStatus::kRunning) << "client " << index;
+    EXPECT_TRUE(event.counting);
+  }
+
+  std::raise(SIGTERM);
+  daemon.join();
+  EXPECT_EQ(status, kSignalExitBase + SIGTERM);
+  for (const TestClient& client : clients) {
+    close(client.fd);
+  }
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
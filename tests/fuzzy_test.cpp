@@ -0,0 +1,95 @@
+#include "fuzzy.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+// Indices of the options matching the query so far
+std::vector<int> matched(const FuzzyFilter& filter) {
+  std::vector<int> indices;
+  for (const FuzzyMatch& match : fuzzy_filter_matches(filter)) {
+    indices.push_back(match.index);
+  }
+  return indices;
+}
+
+void type(FuzzyFilter& filter, const std::vector<std::string>& options,
+          std::string_view letters) {
+  for (const char letter : letters) {
+    fuzzy_filter_push(filter, options, letter);
+  }
+}
+}  // namespace
+
+TEST(FuzzyTest, EmptyQueryMatchesEverything) {
+  const std::vector<std::string> options = {"a", "b", "c"};
+  const FuzzyFilter filter = fuzzy_filter_make(options.size());
+  EXPECT_EQ(matched(filter), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(FuzzyTest, LettersMustAppearInOrder) {
+  const std::vector<std::string> options = {"study", "dusty", "sdy",
+                                            "stud"};
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  type(filter, options, "sdy");
+  EXPECT_EQ(filter.query, "sdy");
+  // "dusty" has all three letters, but not in that order
+  EXPECT_EQ(matched(filter), (std::vector<int>{0, 2}));
+}
+
+TEST(FuzzyTest, MatchingIgnoresCase) {
+  const std::vector<std::string> options = {"Deep Work", "deep work",
+                                            "DEEP WORK", "Reading"};
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  type(filter, options, "dW");
+  EXPECT_EQ(matched(filter), (std::vector<int>{0, 1, 2}));
+}
+
+// Each match resumes after the previous letter's hit, so a repeated letter
+// needs a second occurrence
+TEST(FuzzyTest, RepeatedLetterNeedsASecondOccurrence) {
+  const std::vector<std::string> options = {"book", "bok"};
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  type(filter, options, "oo");
+  EXPECT_EQ(matched(filter), (std::vector<int>{0}));
+}
+
+TEST(FuzzyTest, BackspaceRestoresThePreviousLevel) {
+  const std::vector<std::string> options = {"maths", "music", "physics",
+                                            "history"};
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  type(filter, options, "s");
+  const std::vector<int> after_s = matched(filter);
+  EXPECT_EQ(after_s, (std::vector<int>{0, 1, 2, 3}));
+  type(filter, options, "c");
+  EXPECT_EQ(matched(filter), (std::vector<int>{1, 2}));
+  type(filter, options, "x");
+  EXPECT_TRUE(matched(filter).empty());
+
+  fuzzy_filter_pop(filter);
+  EXPECT_EQ(filter.query, "sc");
+  EXPECT_EQ(matched(filter), (std::vector<int>{1, 2}));
+  fuzzy_filter_pop(filter);
+  EXPECT_EQ(matched(filter), after_s);
+  fuzzy_filter_pop(filter);
+  EXPECT_EQ(matched(filter).size(), options.size());
+  // Backspace on an empty query is a no-op
+  fuzzy_filter_pop(filter);
+  EXPECT_TRUE(filter.query.empty());
+  EXPECT_EQ(matched(filter).size(), options.size());
+}
+
+// Typing again after a backspace narrows into the dropped level's storage
+TEST(FuzzyTest, RetypingAfterBackspaceReusesStorage) {
+  const std::vector<std::string> options = {"alpha", "beta", "gamma"};
+  FuzzyFilter filter = fuzzy_filter_make(options.size());
+  type(filter, options, "a");
+  const FuzzyMatch* storage = fuzzy_filter_matches(filter).data();
+  fuzzy_filter_pop(filter);
+  type(filter, options, "m");
+  EXPECT_EQ(fuzzy_filter_matches(filter).data(), storage);
+  EXPECT_EQ(matched(filter), (std::vector<int>{2}));
+}
@@ -0,0 +1,39 @@
+#include "headless_renderer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+TEST(HeadlessRendererTest, RecordsFramesInMemory) {
+  RecordingRenderer renderer;
+  renderer.put(1, 2, "Time: 25:00", Attr::kNormal);
+  renderer.flush();
+  renderer.put(1, 8, "24:59", Attr::kReverse);
+  renderer.flush();
+  ASSERT_EQ(renderer.frames().size(), 2U);
+  EXPECT_EQ(renderer.frames()[0].rows[1].substr(0, 13), U"  Time: 25:00");
+  EXPECT_EQ(renderer.frames()[1].rows[1].substr(0, 13), U"  Time: 24:59");
+  EXPECT_EQ(renderer.frames()[1].reverse[1].substr(0, 13), "        ^^^^^");
+}
+
+TEST(HeadlessRendererTest, StreamsFramesToFileWithoutKeepingThem) {
+  const std::string path = testing::TempDir() + "recording.txt";
+  {
+    RecordingRenderer renderer(path);
+    for (int frame = 0; frame < 1000; ++frame) {
+      renderer.put(0, 0, frame % 2 == 0 ? "even" : "odd ", Attr::kNormal);
+      renderer.flush();
+    }
+    EXPECT_TRUE(renderer.frames().empty());
+    EXPECT_EQ(renderer.output_stats()->frames, 1000U);
+  }
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  EXPECT_NE(text.str().find("=== frame 1 ===\n| even\n"), std::string::npos);
+  EXPECT_NE(text.str().find("=== frame 1000 ===\n| odd\n"), std::string::npos);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,375 @@
+#include "ipc.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "session.h"
+#include "timer_manager.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// A path in a fresh directory; kept short to fit in sun_path
+std::string fresh_path(const std::string& name) {
+  const std::filesystem::path dir =
+      std::filesystem::path(::testing::TempDir()) /
+      ("pomodoro-ipc-" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  std::filesystem::remove(dir / name);
+  return (dir / name).string();
+}
+
+// A connected stream pair; reads from the first end do not block, as the
+// daemon and client sockets do not
+struct SocketPair {
+  SocketPair() {
+    EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+  }
+  SocketPair(const SocketPair&) = delete;
+  SocketPair& operator=(const SocketPair&) = delete;
+  SocketPair(SocketPair&&) = delete;
+  SocketPair& operator=(SocketPair&&) = delete;
+  ~SocketPair() {
+    close(fds[0]);
+    if (fds[1] >= 0) {
+      close(fds[1]);
+    }
+  }
+
+  [[nodiscard]] int reader() const { return fds[0]; }
+  void send(std::span<const std::uint8_t> bytes) const {
+    EXPECT_TRUE(ipc_send(fds[1], bytes));
+  }
+  void hang_up() {
+    close(fds[1]);
+    fds[1] = -1;
+  }
+
+  std::array<int, 2> fds{};
+};
+
+// Frames encoded back to back, as a peer sending several at once would
+class Encoded {
+ public:
+  Encoded& event(const SessionEvent& event) {
+    return add(ipc_encode_event(event, space()));
+  }
+  Encoded& command(MessageType command) {
+    return add(ipc_encode_command(command, space()));
+  }
+  Encoded& attach(std::string_view name) {
+    return add(ipc_encode_attach(name, space()));
+  }
+  Encoded& raw(std::initializer_list<std::uint8_t> bytes) {
+    bytes_.insert(bytes_.end(), bytes);
+    used_ = bytes_.size();
+    return *this;
+  }
+  [[nodiscard]] std::span<const std::uint8_t> bytes() const { return bytes_; }
+
+ private:
+  std::span<std::uint8_t> space() {
+    bytes_.resize(used_ + kMaxMessageLength);
+    return std::span(bytes_).subspan(used_);
+  }
+  Encoded& add(std::size_t length) {
+    EXPECT_NE(length, 0U);
+    used_ += length;
+    bytes_.resize(used_);
+    return *this;
+  }
+
+  std::vector<std::uint8_t> bytes_;
+  std::size_t used_ = 0;
+};
+
+constexpr SessionEvent kBreakEvent{true, SessionStatus::kBreakRunning, 300s,
+                                   true, 123456ms};
+
+void expect_same(const SessionEvent& actual, const SessionEvent& expected) {
+  EXPECT_EQ(actual.on_break, expected.on_break);
+  EXPECT_EQ(actual.status, expected.status);
+  EXPECT_EQ(actual.total, expected.total);
+  EXPECT_EQ(actual.counting, expected.counting);
+  EXPECT_EQ(actual.remaining, expected.remaining);
+}
+
+// Sends encoded and takes the one frame it holds
+Frame decode_one(FrameBuffer& input, const SocketPair& pair,
+                 const Encoded& encoded) {
+  pair.send(encoded.bytes());
+  EXPECT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  Frame frame{};
+  EXPECT_TRUE(input.next(frame));
+  return frame;
+}
+}  // namespace
+
+TEST(IpcTest, ListenRefusesToReplaceARegularFile) {
+  const std::string path = fresh_path("notasock");
+  std::ofstream(path) << "keep me\n";
+  std::string error;
+  EXPECT_LT(ipc_listen(path, error), 0);
+  EXPECT_NE(error.find("not a socket"), std::string::npos) << error;
+  ipc_unlink(path);
+  EXPECT_TRUE(std::filesystem::is_regular_file(path));
+}
+
+TEST(IpcTest, ListenReplacesAStaleSocket) {
+  const std::string path = fresh_path("stale.sock");
+  std::string error;
+  const int first = ipc_listen(path, error);
+  ASSERT_GE(first, 0) << error;
+  // Closed without unlinking, as a crashed daemon leaves it
+  close(first);
+  const int second = ipc_listen(path, error);
+  ASSERT_GE(second, 0) << error;
+  const int client = ipc_connect(path);
+  EXPECT_GE(client, 0);
+  close(client);
+  close(second);
+  ipc_unlink(path);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(IpcTest, ListenLeavesALiveDaemonAlone) {
+  const std::string path = fresh_path("live.sock");
+  std::string error;
+  const int live = ipc_listen(path, error);
+  ASSERT_GE(live, 0) << error;
+  EXPECT_LT(ipc_listen(path, error), 0);
+  EXPECT_NE(error.find("already listening"), std::string::npos) << error;
+  close(live);
+  ipc_unlink(path);
+}
+
+TEST(IpcTest, EventRoundTrips) {
+  const std::array<SessionEvent, 3> events = {{
+      {false, SessionStatus::kStopped, 1500s, false, 1500000ms},
+      {false, SessionStatus::kPaused, 1500s, false, 61ms},
+      kBreakEvent,
+  }};
+  SocketPair pair;
+  FrameBuffer input;
+  for (const SessionEvent& sent : events) {
+    const Frame frame = decode_one(input, pair, Encoded().event(sent));
+    EXPECT_EQ(frame.type, MessageType::kState);
+    SessionEvent received{};
+    ASSERT_TRUE(ipc_decode_event(frame, received));
+    expect_same(received, sent);
+  }
+}
+
+TEST(IpcTest, CommandsRoundTrip) {
+  SocketPair pair;
+  FrameBuffer input;
+  for (const MessageType command :
+       {MessageType::kStartPause, MessageType::kReset, MessageType::kQuit}) {
+    const Frame frame = decode_one(input, pair, Encoded().command(command));
+    EXPECT_EQ(frame.type, command);
+    EXPECT_TRUE(frame.payload.empty());
+    SessionEvent event{};
+    EXPECT_FALSE(ipc_decode_event(frame, event));
+  }
+}
+
+TEST(IpcTest, AttachRoundTrips) {
+  SocketPair pair;
+  FrameBuffer input;
+  const std::string longest(kMaxTimerNameLength, 'n');
+  for (const std::string_view sent : {std::string_view("desk-3"),
+                                      std::string_view(""),
+                                      std::string_view(longest)}) {
+    const Frame frame = decode_one(input, pair, Encoded().attach(sent));
+    std::string_view name;
+    ASSERT_TRUE(ipc_decode_attach(frame, name));
+    EXPECT_EQ(name, sent);
+  }
+  std::array<std::uint8_t, kMaxMessageLength> out{};
+  EXPECT_EQ(ipc_encode_attach(longest + "x", out), 0U);
+}
+
+TEST(IpcTest, EventWithInvalidFieldsIsRejected) {
+  SocketPair pair;
+  FrameBuffer input;
+  // Status 7 does not exist; a zero total is not a phase
+  const Frame bad_status = decode_one(
+      input, pair,
+      Encoded().raw({kProtocolVersion, 1, 20, 0, 0, 7, 0, 0, 60, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+  SessionEvent event{};
+  EXPECT_FALSE(ipc_decode_event(bad_status, event));
+  const Frame zero_total = decode_one(
+      input, pair,
+      Encoded().raw({kProtocolVersion, 1, 20, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+  EXPECT_FALSE(ipc_decode_event(zero_total, event));
+  // A kState payload of the wrong length
+  const Frame short_payload = decode_one(
+      input, pair, Encoded().raw({kProtocolVersion, 1, 2, 0, 0, 1}));
+  EXPECT_FALSE(ipc_decode_event(short_payload, event));
+}
+
+TEST(IpcTest, FrameSplitAcrossReads) {
+  SocketPair pair;
+  FrameBuffer input;
+  const Encoded encoded = Encoded().event(kBreakEvent);
+  const auto bytes = encoded.bytes();
+  Frame frame{};
+  // Part of the header, then the rest of the header and part of the payload
+  pair.send(bytes.first(2));
+  EXPECT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  EXPECT_FALSE(input.next(frame));
+  pair.send(bytes.subspan(2, 9));
+  EXPECT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  EXPECT_FALSE(input.next(frame));
+  pair.send(bytes.subspan(11));
+  EXPECT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  ASSERT_TRUE(input.next(frame));
+  SessionEvent event{};
+  ASSERT_TRUE(ipc_decode_event(frame, event));
+  expect_same(event, kBreakEvent);
+  EXPECT_FALSE(input.next(frame));
+  EXPECT_FALSE(input.malformed());
+}
+
+TEST(IpcTest, SeveralFramesInOneRead) {
+  SocketPair pair;
+  FrameBuffer input;
+  pair.send(Encoded()
+                .attach("desk")
+                .command(MessageType::kStartPause)
+                .event(kBreakEvent)
+                .command(MessageType::kQuit)
+                .bytes());
+  ASSERT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  Frame frame{};
+  std::string_view name;
+  ASSERT_TRUE(input.next(frame));
+  ASSERT_TRUE(ipc_decode_attach(frame, name));
+  EXPECT_EQ(name, "desk");
+  ASSERT_TRUE(input.next(frame));
+  EXPECT_EQ(frame.type, MessageType::kStartPause);
+  ASSERT_TRUE(input.next(frame));
+  SessionEvent event{};
+  ASSERT_TRUE(ipc_decode_event(frame, event));
+  expect_same(event, kBreakEvent);
+  ASSERT_TRUE(input.next(frame));
+  EXPECT_EQ(frame.type, MessageType::kQuit);
+  EXPECT_FALSE(input.next(frame));
+}
+
+// More than the buffer holds at once: fill() stops at kFull, and the partial
+// frame at the end is carried over to the next fill()
+TEST(IpcTest, FramesBeyondOneBufferfulArriveInOrder) {
+  constexpr int kFrames = 100;
+  SocketPair pair;
+  FrameBuffer input;
+  Encoded encoded;
+  for (int index = 0; index < kFrames; ++index) {
+    encoded.attach("timer-" + std::to_string(index));
+  }
+  // FrameBuffer holds 1024 bytes
+  ASSERT_GT(encoded.bytes().size(), 1024U);
+  pair.send(encoded.bytes());
+  int received = 0;
+  ReadResult result = ReadResult::kFull;
+  while (result == ReadResult::kFull) {
+    result = input.fill(pair.reader());
+    Frame frame{};
+    std::string_view name;
+    while (input.next(frame)) {
+      ASSERT_TRUE(ipc_decode_attach(frame, name));
+      EXPECT_EQ(name, "timer-" + std::to_string(received));
+      ++received;
+    }
+  }
+  EXPECT_EQ(result, ReadResult::kDrained);
+  EXPECT_EQ(received, kFrames);
+}
+
+TEST(IpcTest, UnknownTypeIsHandedOutAndSkipped) {
+  SocketPair pair;
+  FrameBuffer input;
+  pair.send(Encoded()
+                .raw({kProtocolVersion, 99, 2, 0, 0xaa, 0xbb})
+                .command(MessageType::kReset)
+                .bytes());
+  ASSERT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  Frame frame{};
+  ASSERT_TRUE(input.next(frame));
+  EXPECT_EQ(static_cast<int>(frame.type), 99);
+  EXPECT_EQ(frame.payload.size(), 2U);
+  SessionEvent event{};
+  std::string_view name;
+  EXPECT_FALSE(ipc_decode_event(frame, event));
+  EXPECT_FALSE(ipc_decode_attach(frame, name));
+  ASSERT_TRUE(input.next(frame));
+  EXPECT_EQ(frame.type, MessageType::kReset);
+  EXPECT_FALSE(input.malformed());
+}
+
+TEST(IpcTest, UnknownVersionIsMalformed) {
+  SocketPair pair;
+  FrameBuffer input;
+  pair.send(Encoded()
+                .raw({kProtocolVersion + 1, 2, 0, 0})
+                .command(MessageType::kReset)
+                .bytes());
+  ASSERT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  Frame frame{};
+  EXPECT_FALSE(input.next(frame));
+  EXPECT_TRUE(input.malformed());
+  // Nothing after it is trusted
+  EXPECT_FALSE(input.next(frame));
+}
+
+TEST(IpcTest, LengthOverTheMaximumIsMalformed) {
+  constexpr std::size_t kLongestPayload =
+      kMaxMessageLength - kFrameHeaderLength;
+  SocketPair pair;
+  FrameBuffer input;
+  // The longest allowed frame is accepted, one byte more is not
+  Encoded longest;
+  longest.raw({kProtocolVersion, 99, kLongestPayload, 0});
+  for (std::size_t byte = 0; byte < kLongestPayload; ++byte) {
+    longest.raw({0});
+  }
+  const Frame frame = decode_one(input, pair, longest);
+  EXPECT_EQ(frame.payload.size(), kLongestPayload);
+
+  pair.send(Encoded()
+                .raw({kProtocolVersion, 5, kLongestPayload + 1, 0})
+                .bytes());
+  ASSERT_EQ(input.fill(pair.reader()), ReadResult::kDrained);
+  Frame oversized{};
+  EXPECT_FALSE(input.next(oversized));
+  EXPECT_TRUE(input.malformed());
+}
+
+TEST(IpcTest, FillReportsAClosedPeer) {
+  SocketPair pair;
+  FrameBuffer input;
+  pair.send(Encoded().command(MessageType::kQuit).bytes());
+  pair.hang_up();
+  EXPECT_EQ(input.fill(pair.reader()), ReadResult::kClosed);
+  // Frames that arrived before the hangup are still delivered
+  Frame frame{};
+  ASSERT_TRUE(input.next(frame));
+  EXPECT_EQ(frame.type, MessageType::kQuit);
+}
@@ -0,0 +1,119 @@
+#include "keymap.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+// Writes contents to a fresh file and returns its path
+std::string write_config(const std::string& name,
+                         const std::string& contents) {
+  const std::filesystem::path dir =
+      std::filesystem::path(::testing::TempDir()) /
+      ("pomodoro-keymap-" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  const std::string path = (dir / name).string();
+  std::ofstream(path) << contents;
+  return path;
+}
+
+constexpr int kEscapeKey = 27;
+
+struct BadConfig {
+  const char* contents;
+  // What the error reads after the path
+  const char* reason;
+};
+}  // namespace
+
+TEST(KeymapTest, BindingReplacesTheDefault) {
+  Keymap keymap = keymap_defaults();
+  ASSERT_EQ(keymap_lookup(keymap, KeyContext::kTimer, 's'),
+            Action::kStartPause);
+  const std::string path = write_config(
+      "replace.conf", "# swap start and reset\n"
+                      "\n"
+                      "timer s reset\n"
+                      "timer space start_pause\n"
+                      "menu tab down\n");
+  std::string error;
+  ASSERT_TRUE(keymap_load(keymap, path, error)) << error;
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kTimer, 's'), Action::kReset);
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kTimer, ' '),
+            Action::kStartPause);
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kMenu, '\t'), Action::kDown);
+  // Only the named screen changes
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kPrompt, ' '), Action::kNone);
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kTimer, 'r'), Action::kReset);
+}
+
+TEST(KeymapTest, AllAppliesToEveryScreen) {
+  Keymap keymap = keymap_defaults();
+  const std::string path = write_config("all.conf", "all esc quit\n");
+  std::string error;
+  ASSERT_TRUE(keymap_load(keymap, path, error)) << error;
+  for (const KeyContext context :
+       {KeyContext::kTimer, KeyContext::kMenu, KeyContext::kPrompt}) {
+    EXPECT_EQ(keymap_lookup(keymap, context, kEscapeKey), Action::kQuit);
+  }
+}
+
+TEST(KeymapTest, MissingFileIsAccepted) {
+  Keymap keymap = keymap_defaults();
+  std::string error;
+  EXPECT_TRUE(keymap_load(keymap,
+                          ::testing::TempDir() + "pomodoro-no-such-keys.conf",
+                          error));
+  EXPECT_TRUE(error.empty());
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kTimer, 'q'), Action::kQuit);
+}
+
+TEST(KeymapTest, MalformedLineReportsPathAndLine) {
+  const std::array<BadConfig, 5> cases = {{
+      {"timer q quit\n\ntimer q\n", ":3: expected"},
+      {"timer q quit extra\n", ":1: expected"},
+      {"# comment\nscreen q quit\n", ":2: unknown screen"},
+      {"timer f13 quit\n", ":1: unknown key"},
+      {"timer q explode\n", ":1: unknown action"},
+  }};
+  int index = 0;
+  for (const auto& bad : cases) {
+    const std::string path =
+        write_config("bad" + std::to_string(index++) + ".conf", bad.contents);
+    Keymap keymap = keymap_defaults();
+    std::string error;
+    EXPECT_FALSE(keymap_load(keymap, path, error)) << bad.contents;
+    EXPECT_EQ(error.rfind(path + bad.reason, 0), 0U) << error;
+  }
+}
+
+// Every character from space to '~' must reach the menu's type-to-filter
+TEST(KeymapTest, MenuNeverBindsPrintableKeys) {
+  const auto expect_typing_keys_free = [](const Keymap& keymap) {
+    for (int key = ' '; key <= '~'; ++key) {
+      EXPECT_EQ(keymap_lookup(keymap, KeyContext::kMenu, key), Action::kNone)
+          << "key " << key;
+    }
+  };
+  expect_typing_keys_free(keymap_defaults());
+
+  // "all" binds the other screens and leaves the menu alone
+  Keymap keymap = keymap_defaults();
+  const std::string all =
+      write_config("all_letters.conf", "all x quit\nall space reset\n");
+  std::string error;
+  ASSERT_TRUE(keymap_load(keymap, all, error)) << error;
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kTimer, 'x'), Action::kQuit);
+  EXPECT_EQ(keymap_lookup(keymap, KeyContext::kPrompt, ' '), Action::kReset);
+  expect_typing_keys_free(keymap);
+
+  // Naming the menu is an error
+  const std::string menu = write_config("menu_letter.conf", "menu j down\n");
+  EXPECT_FALSE(keymap_load(keymap, menu, error));
+  EXPECT_NE(error.find("menu filter"), std::string::npos) << error;
+  expect_typing_keys_free(keymap);
+}
@@ -0,0 +1,145 @@
+#include "pomodoro.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "alloc_count.h"
+#include "clock.h"
+#include "headless_renderer.h"
+#include "keymap.h"
+#include "screen.h"
+#include "session.h"
+#include "stats.h"
+#include "status_file.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr SessionTime kStudy{25min};
+constexpr SessionTime kBreak{5min};
+
+// Scripts two study/break cycles with a pause, a reset and a restart in
+// between, then quits from the timer screen
+void script_session(VirtualClock& clock) {
+  const Clock::time_point start = clock.now();
+  clock.type_at(start, "s");
+  clock.type_at(start + 3min, "s");
+  clock.type_at(start + 20min, "s");
+  clock.type_at(start + 21min, "r");
+  clock.type_at(start + 22min, "s");
+  // Study ends at 47 min, break runs 48..53 min
+  clock.type_at(start + 48min, " ");
+  clock.type_at(start + 54min, " ");
+  // Second study ends at 79 min, break runs 80..85 min
+  clock.type_at(start + 80min, " ");
+  clock.type_at(start + 86min, " ");
+  clock.type_at(start + 90min, "q");
+}
+
+// Whether any row of frame contains text
+bool frame_shows(const RecordedFrame& frame, std::u32string_view text) {
+  for (const std::u32string& row : frame.rows) {
+    if (row.find(text) != std::u32string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A fresh directory for the checkpoint and status files; the loop's first
+// save would otherwise create it, which is startup work rather than steady
+// state (CheckpointLock::acquire creates it in the real binary)
+std::filesystem::path fresh_dir(const std::string& name) {
+  const std::filesystem::path dir =
+      std::filesystem::path(::testing::TempDir()) /
+      ("pomodoro-loop-" + std::to_string(getpid())) / name;
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+// Heap allocations made by one scripted run of the event loop, with every
+// state change checkpointed and published as in a real run
+std::uint64_t loop_allocations(LoopStats* stats, const std::string& name) {
+  const std::filesystem::path dir = fresh_dir(name);
+  const std::string checkpoint_path = (dir / "checkpoint").string();
+  const std::string status_path = (dir / "status").string();
+  VirtualClock clock;
+  script_session(clock);
+  NullRenderer renderer(clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+  std::string error;
+  EXPECT_TRUE(status_file.open(status_path, error)) << error;
+
+  const std::uint64_t before = allocation_count();
+  pomodoro_event_loop(kStudy, kBreak, session, clock, screen, checkpoint_path,
+                      status_file, stats);
+  const std::uint64_t allocations = allocation_count() - before;
+
+  EXPECT_EQ(session.status, SessionStatus::kRunning);
+  EXPECT_GT(renderer.output_stats()->frames, 0U);
+  // The loop did publish; quitting removed the checkpoint it kept
+  StatusReader reader;
+  StatusSnapshot snapshot{};
+  EXPECT_TRUE(reader.open(status_path) &&
+              reader.read(clock.now(), snapshot));
+  EXPECT_TRUE(snapshot.active);
+  EXPECT_EQ(snapshot.status, SessionStatus::kRunning);
+  EXPECT_FALSE(std::filesystem::exists(checkpoint_path));
+  EXPECT_FALSE(std::filesystem::exists(checkpoint_path + ".tmp"));
+  return allocations;
+}
+}  // namespace
+
+TEST(PomodoroTest, AllocationsAreCounted) {
+  EXPECT_TRUE(allocations_counted());
+  const std::uint64_t before = allocation_count();
+  const auto value = std::make_unique<int>(1);
+  EXPECT_EQ(allocation_count() - before, 1U);
+}
+
+TEST(PomodoroTest, SteadyStateLoopDoesNotAllocate) {
+  EXPECT_EQ(loop_allocations(nullptr, "plain"), 0U);
+}
+
+TEST(PomodoroTest, SteadyStateLoopWithStatsDoesNotAllocate) {
+  LoopStats stats{};
+  EXPECT_EQ(loop_allocations(&stats, "stats"), 0U);
+  EXPECT_EQ(stats.allocations.total, 0U);
+  EXPECT_GT(stats.wakeups.total, 0U);
+}
+
+TEST(PomodoroTest, BurstOfQueuedKeysCostsOneFrame) {
+  constexpr std::size_t kBurst = 1000;
+  VirtualClock clock;
+  // An even number of start/pause toggles leaves the timer paused, so
+  // nothing else draws until the quit
+  clock.type_at(clock.now() + 1s, std::string(kBurst, 's'));
+  clock.type_at(clock.now() + 1min, "q");
+  RecordingRenderer renderer({}, clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+  LoopStats stats{};
+  pomodoro_event_loop(kStudy, kBreak, session, clock, screen, {}, status_file,
+                      &stats);
+
+  EXPECT_EQ(stats.keys.total, kBurst + 1);
+  EXPECT_EQ(stats.max_keys_per_wakeup, kBurst);
+  // The first frame, then one for the whole burst
+  ASSERT_EQ(renderer.frames().size(), 2U);
+  EXPECT_TRUE(frame_shows(renderer.frames()[0], U"Status: Stopped"));
+  EXPECT_TRUE(frame_shows(renderer.frames()[1], U"Status: Paused"));
+  EXPECT_TRUE(frame_shows(renderer.frames()[1], U"Time: 25:00"));
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "clock.h"
+#include "headless_renderer.h"
+#include "keymap.h"
+#include "pomodoro.h"
+#include "screen.h"
+#include "session.h"
+#include "status_file.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr SessionTime kStudy{25min};
+constexpr SessionTime kBreak{5min};
+// How long the simulated user takes to answer each end-of-phase prompt
+constexpr Clock::duration kAfterStudy = 2min;
+constexpr Clock::duration kAfterBreak = 1min;
+constexpr Clock::duration kCycle =
+    kStudy.length + kAfterStudy + kBreak.length + kAfterBreak;
+
+struct Simulation {
+  Clock::duration elapsed;
+  SessionState session;
+  OutputStats output;
+};
+
+// Runs cycles full study/break cycles in virtual time: the user starts the
+// first study at once and answers every prompt after a pause. Once the
+// script runs out the next prompt sees end of input and the run quits.
+Simulation simulate(int cycles) {
+  VirtualClock clock;
+  const Clock::time_point start = clock.now();
+  clock.type_at(start, "s");
+  for (int cycle = 0; cycle < cycles; ++cycle) {
+    const Clock::time_point begin = start + (kCycle * cycle);
+    clock.type_at(begin + kStudy.length + kAfterStudy, " ");
+    clock.type_at(begin + kCycle, " ");
+  }
+
+  NullRenderer renderer(clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+  const bool interrupted = pomodoro_event_loop(kStudy, kBreak, session, clock,
+                                               screen, {}, status_file);
+  EXPECT_FALSE(interrupted);
+  return {clock.now() - start, session, *renderer.output_stats()};
+}
+}  // namespace
+
+TEST(SimulationTest, DayOfSessionsEndsOnTheMinute) {
+  constexpr int kCycles = 24 * 60min / kCycle;
+  const Simulation run = simulate(kCycles);
+  // The last answer starts one more study, which then ends at a prompt
+  EXPECT_EQ(run.elapsed, (kCycle * kCycles) + kStudy.length);
+  EXPECT_TRUE(run.session.on_break);
+  EXPECT_EQ(run.session.status, SessionStatus::kBreakReady);
+  // At least one frame per displayed second of every phase
+  const auto counted =
+      duration_cast<seconds>((kStudy.length + kBreak.length) * kCycles);
+  EXPECT_GE(run.output.frames, static_cast<std::uint64_t>(counted.count()));
+}
+
+TEST(SimulationTest, EndOfScriptQuitsInsteadOfSpinning) {
+  VirtualClock clock;
+  NullRenderer renderer(clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+  // Stopped timer, nothing scripted: the wait has no deadline
+  EXPECT_FALSE(pomodoro_event_loop(kStudy, kBreak, session, clock, screen, {},
+                                   status_file));
+  EXPECT_EQ(session.status, SessionStatus::kStopped);
+}
+
+TEST(SimulationTest, PauseFreezesTheCountdown) {
+  VirtualClock clock;
+  const Clock::time_point start = clock.now();
+  clock.type_at(start, "s");
+  clock.type_at(start + 10min, "s");
+  clock.type_at(start + 3h, "s");
+  clock.type_at(start + 3h + 1min, "q");
+  NullRenderer renderer(clock.input_fd());
+  const Keymap keymap = keymap_defaults();
+  Screen screen(renderer, keymap, clock);
+  SessionState session = session_make(kStudy);
+  StatusPublisher status_file;
+  pomodoro_event_loop(kStudy, kBreak, session, clock, screen, {}, status_file);
+  EXPECT_EQ(timer_remaining(session.tick, clock.now()), 14min);
+  EXPECT_EQ(session.status, SessionStatus::kRunning);
+}
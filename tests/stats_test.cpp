@@ -0,0 +1,52 @@
+#include "stats.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "clock.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// Records one event per second from start for length
+Clock::time_point tick_every_second(RateCounter& counter,
+                                    Clock::time_point start,
+                                    Clock::duration length) {
+  Clock::time_point now = start;
+  for (; now < start + length; now += 1s) {
+    rate_record(counter, now);
+  }
+  return now;
+}
+}  // namespace
+
+TEST(StatsTest, SteadyRateReadsPerMinute) {
+  RateCounter counter{};
+  const Clock::time_point end =
+      tick_every_second(counter, Clock::time_point(1h), 5min);
+  EXPECT_EQ(rate_per_minute(counter, end - 1s), 60U);
+  EXPECT_EQ(counter.total, 300U);
+}
+
+TEST(StatsTest, RateFallsWhileNothingIsRecorded) {
+  RateCounter counter{};
+  const Clock::time_point end =
+      tick_every_second(counter, Clock::time_point(1h), 5min);
+  EXPECT_EQ(rate_per_minute(counter, end + 29s), 30U);
+  EXPECT_EQ(rate_per_minute(counter, end + 10min), 0U);
+}
+
+TEST(StatsTest, WakeupAfterLongPauseReadsNearZero) {
+  RateCounter counter{};
+  const Clock::time_point end =
+      tick_every_second(counter, Clock::time_point(1h), 5min);
+  // The paused loop wakes once, for the key that resumes it
+  rate_record(counter, end + 10min);
+  EXPECT_EQ(rate_per_minute(counter, end + 10min), 1U);
+}
+
+TEST(StatsTest, UnusedCounterReadsZero) {
+  const RateCounter counter{};
+  EXPECT_EQ(rate_per_minute(counter, Clock::time_point(1h)), 0U);
+}
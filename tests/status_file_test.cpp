@@ -0,0 +1,129 @@
+#include "status_file.h"
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+
+#include "clock.h"
+#include "session.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr SessionTime kStudy{25min};
+constexpr SessionTime kBreak{5min};
+
+// A path in a fresh directory
+std::string fresh_path(const std::string& name) {
+  const std::filesystem::path dir =
+      std::filesystem::path(::testing::TempDir()) /
+      ("pomodoro-status-" + std::to_string(getpid())) / name;
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return (dir / "status").string();
+}
+}  // namespace
+
+TEST(StatusFileTest, ReaderSeesWhatWasPublished) {
+  const std::string path = fresh_path("round_trip");
+  SteadyClock clock;
+  SessionState session = session_make(kStudy);
+  session_apply(session, SessionCommand::kStartPause, kStudy, kBreak,
+                clock.now());
+  StatusSnapshot snapshot{};
+  {
+    StatusPublisher publisher;
+    std::string error;
+    ASSERT_TRUE(publisher.open(path, error)) << error;
+    publisher.publish(session);
+
+    StatusReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_TRUE(reader.read(clock.now(), snapshot));
+    EXPECT_TRUE(snapshot.active);
+    EXPECT_EQ(snapshot.status, SessionStatus::kRunning);
+    EXPECT_TRUE(snapshot.counting);
+    EXPECT_EQ(snapshot.total, kStudy.length);
+    EXPECT_LE(snapshot.remaining, kStudy.length);
+    EXPECT_GT(snapshot.remaining, kStudy.length - 1min);
+  }
+  // The publisher marks the record inactive as it lets go
+  StatusReader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_TRUE(reader.read(clock.now(), snapshot));
+  EXPECT_FALSE(snapshot.active);
+}
+
+// Reads the file the way another program would, from the offsets documented
+// in status_file.h rather than through StatusRecord
+TEST(StatusFileTest, FileMatchesTheDocumentedLayout) {
+  const std::string path = fresh_path("layout");
+  SteadyClock clock;
+  SessionState session = session_make(kStudy);
+  session_apply(session, SessionCommand::kStartPause, kStudy, kBreak,
+                clock.now());
+  StatusPublisher publisher;
+  std::string error;
+  ASSERT_TRUE(publisher.open(path, error)) << error;
+  publisher.publish(session);
+
+  std::array<char, sizeof(StatusRecord)> bytes{};
+  std::ifstream(path, std::ios::binary).read(bytes.data(), bytes.size());
+  const auto field = [&](std::size_t offset, auto value) {
+    std::memcpy(&value, std::span(bytes).subspan(offset).data(),
+                sizeof(value));
+    return value;
+  };
+  EXPECT_EQ(field(0, std::uint32_t{}), kStatusMagic);
+  EXPECT_EQ(field(4, std::uint32_t{}), kStatusVersion);
+  EXPECT_EQ(field(8, std::uint64_t{}) % 2, 0U);
+  EXPECT_EQ(field(16, std::uint64_t{}), 1U);
+  EXPECT_EQ(field(24, std::uint64_t{}), 0U);
+  EXPECT_EQ(field(32, std::uint64_t{}), 1U);  // Running
+  EXPECT_EQ(field(40, std::uint64_t{}), 1U);
+  EXPECT_EQ(field(48, std::int64_t{}), 25 * 60);
+  EXPECT_GT(field(64, std::int64_t{}), 0);
+}
+
+TEST(StatusFileTest, SecondPublisherIsRefused) {
+  const std::string path = fresh_path("second");
+  StatusPublisher first;
+  StatusPublisher second;
+  std::string error;
+  ASSERT_TRUE(first.open(path, error)) << error;
+  EXPECT_FALSE(second.open(path, error));
+  EXPECT_NE(error.find("another timer"), std::string::npos) << error;
+}
+
+// A symlink planted at the predictable /tmp path must not redirect the
+// truncate and mapping onto its target
+TEST(StatusFileTest, PublisherRefusesASymlinkAndLeavesItsTargetAlone) {
+  const std::string path = fresh_path("symlink");
+  const std::string target = path + ".victim";
+  std::ofstream(target) << "precious\n";
+  std::filesystem::create_symlink(target, path);
+  StatusPublisher publisher;
+  std::string error;
+  EXPECT_FALSE(publisher.open(path, error));
+  EXPECT_EQ(std::filesystem::file_size(target), 9U);
+}
+
+TEST(StatusFileTest, PublisherRefusesWhatIsNotARegularFile) {
+  const std::string path = fresh_path("fifo");
+  ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+  StatusPublisher publisher;
+  std::string error;
+  EXPECT_FALSE(publisher.open(path, error));
+  EXPECT_NE(error.find("regular file"), std::string::npos) << error;
+  StatusReader reader;
+  EXPECT_FALSE(reader.open(path));
+}
@@ -0,0 +1,97 @@
+#include "timer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+#include "clock.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr seconds kSessionLength = 50min;
+constexpr Clock::duration kMaxError = 10ms;
+constexpr std::uint32_t kSeed = 20240601;
+
+// Wakes the way the event loop does (at the next displayed change), but
+// late by a random scheduling delay of up to max_delay, with an occasional
+// long stall such as a suspended laptop or a stopped process. Pauses for a
+// while every pause_every wakeups when pause_every is nonzero. Checks the
+// countdown against the true running time at every wakeup and returns how
+// far past the deadline the session was noticed to end.
+Clock::duration run_session(Clock::duration max_delay, int pause_every) {
+  std::mt19937 random(kSeed);
+  std::uniform_int_distribution<Clock::duration::rep> delay(
+      0, max_delay.count());
+  std::uniform_int_distribution<int> stall(0, 99);
+  VirtualClock clock(Clock::time_point(1h));
+
+  TimerTickState state = timer_make(kSessionLength);
+  timer_start(state, clock.now());
+  Clock::duration ran{};
+  Clock::time_point resumed = clock.now();
+  for (int wakeup = 1; !timer_tick(state, clock.now()); ++wakeup) {
+    clock.sleep_until(timer_next_change(state, clock.now()));
+    clock.advance(Clock::duration(delay(random)));
+    if (stall(random) == 0) {
+      clock.advance(3s);
+    }
+
+    const Clock::duration truth = std::max<Clock::duration>(
+        kSessionLength - ran - (clock.now() - resumed), 0ns);
+    const Clock::duration error = timer_remaining(state, clock.now()) - truth;
+    EXPECT_LT(abs(error), kMaxError) << "wakeup " << wakeup;
+    EXPECT_EQ(timer_remaining_seconds(state, clock.now()), ceil<seconds>(truth))
+        << "wakeup " << wakeup;
+
+    if (pause_every != 0 && wakeup % pause_every == 0 && truth > 0ns) {
+      timer_pause(state, clock.now());
+      ran += clock.now() - resumed;
+      clock.advance(Clock::duration(delay(random)) * 100);
+      EXPECT_EQ(timer_remaining(state, clock.now()), kSessionLength - ran);
+      timer_start(state, clock.now());
+      resumed = clock.now();
+    }
+  }
+  return ran + (clock.now() - resumed) - kSessionLength;
+}
+}  // namespace
+
+TEST(TimerTest, NoDriftOverFiftyMinutesWithSchedulingDelays) {
+  const Clock::duration overshoot = run_session(50ms, 0);
+  // Noticing the end late is the scheduler's delay, never accumulated error
+  EXPECT_GE(overshoot, 0ns);
+  EXPECT_LE(overshoot, 3s + 50ms);
+}
+
+TEST(TimerTest, NoDriftAcrossPausesWithSchedulingDelays) {
+  const Clock::duration overshoot = run_session(50ms, 37);
+  EXPECT_GE(overshoot, 0ns);
+  EXPECT_LE(overshoot, 3s + 50ms);
+}
+
+TEST(TimerTest, DisplayedSecondChangesAtNextChange) {
+  VirtualClock clock;
+  TimerTickState state = timer_make(10s);
+  timer_start(state, clock.now());
+  clock.advance(250ms);
+  const Clock::time_point next = timer_next_change(state, clock.now());
+  EXPECT_EQ(next - clock.now(), 750ms);
+  EXPECT_EQ(timer_remaining_seconds(state, next - 1ns), 10s);
+  EXPECT_EQ(timer_remaining_seconds(state, next), 9s);
+}
+
+TEST(TimerTest, StoppedTimerHasNoNextChange) {
+  VirtualClock clock;
+  TimerTickState state = timer_make(10s);
+  EXPECT_EQ(timer_next_change(state, clock.now()), Clock::time_point::max());
+  timer_start(state, clock.now());
+  clock.advance(4s);
+  timer_pause(state, clock.now());
+  clock.advance(1h);
+  EXPECT_EQ(timer_remaining(state, clock.now()), 6s);
+  EXPECT_EQ(timer_next_change(state, clock.now()), Clock::time_point::max());
+}
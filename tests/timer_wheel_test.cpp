@@ -0,0 +1,164 @@
+#include "timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "clock.h"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr std::uint32_t kSeed = 20240615;
+constexpr TimerId kIds = 1000;
+constexpr int kSteps = 50000;
+// Past the wheel's ~795 days, so the overflow list is exercised too
+constexpr Clock::duration kFarthest = 3 * 365 * 24h;
+
+// The wheel's contract without the wheel: a deadline rounds up to a whole
+// tick, advance() rounds now down, and a timer is due once its tick has
+// been reached
+class ModelWheel {
+ public:
+  explicit ModelWheel(Clock::time_point start) : start_(start) {}
+
+  void schedule(TimerId id, Clock::time_point deadline) {
+    expiry_[id] = deadline <= start_
+                      ? 0
+                      : ceil<TimerWheel::duration>(deadline - start_).count();
+  }
+  void cancel(TimerId id) { expiry_.erase(id); }
+  [[nodiscard]] bool scheduled(TimerId id) const {
+    return expiry_.contains(id);
+  }
+  std::vector<TimerId> advance(Clock::time_point now) {
+    if (now > start_) {
+      now_tick_ = std::max<std::int64_t>(
+          now_tick_, floor<TimerWheel::duration>(now - start_).count());
+    }
+    std::vector<TimerId> expired;
+    for (auto it = expiry_.begin(); it != expiry_.end();) {
+      if (it->second <= now_tick_) {
+        expired.push_back(it->first);
+        it = expiry_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return expired;
+  }
+  // Earliest pending deadline, no earlier than the last advance, or
+  // time_point::max()
+  [[nodiscard]] Clock::time_point earliest() const {
+    if (expiry_.empty()) {
+      return Clock::time_point::max();
+    }
+    const auto first = std::ranges::min_element(
+        expiry_, {}, &std::map<TimerId, std::int64_t>::value_type::second);
+    return start_ + TimerWheel::duration(std::max(first->second, now_tick_));
+  }
+
+ private:
+  Clock::time_point start_;
+  std::int64_t now_tick_ = 0;
+  std::map<TimerId, std::int64_t> expiry_;
+};
+}  // namespace
+
+// Random schedules, reschedules, cancels and advances of every size, checked
+// step by step against the model
+TEST(TimerWheelTest, MatchesModelUnderRandomOperations) {
+  std::mt19937 random(kSeed);
+  std::uniform_int_distribution<TimerId> any_id(0, kIds - 1);
+  std::uniform_int_distribution<int> operation(0, 99);
+  // Deadlines and steps on every scale, from sub-tick to years
+  std::uniform_int_distribution<int> scale(0, 24);
+  // Rare leaps of up to years, so virtual time stays far from overflowing
+  std::bernoulli_distribution leap(0.001);
+  const auto random_span = [&](Clock::duration limit) {
+    const auto upper = std::min<Clock::duration::rep>(
+        limit.count(), Clock::duration(1us).count() << (2 * scale(random)));
+    return Clock::duration(std::uniform_int_distribution<Clock::duration::rep>(
+        0, upper)(random));
+  };
+
+  const Clock::time_point start(1h);
+  TimerWheel wheel(start);
+  ModelWheel model(start);
+  Clock::time_point now = start;
+  std::vector<TimerId> expired;
+  for (int step = 0; step < kSteps; ++step) {
+    const int choice = operation(random);
+    const TimerId id = any_id(random);
+    if (choice < 55) {
+      // Now and then a deadline that has already passed
+      const Clock::time_point deadline =
+          choice < 5 ? now - random_span(1h) : now + random_span(kFarthest);
+      wheel.schedule(id, deadline);
+      model.schedule(id, deadline);
+    } else if (choice < 70) {
+      wheel.cancel(id);
+      model.cancel(id);
+    } else {
+      now += random_span(leap(random) ? kFarthest : Clock::duration(1h));
+      expired.clear();
+      wheel.advance(now, expired);
+      std::ranges::sort(expired);
+      ASSERT_EQ(expired, model.advance(now)) << "step " << step;
+    }
+    ASSERT_EQ(wheel.scheduled(id), model.scheduled(id)) << "step " << step;
+    // Early is allowed (a slot that only re-files timers), late never
+    ASSERT_LE(wheel.next_deadline(), model.earliest()) << "step " << step;
+    if (model.earliest() == Clock::time_point::max()) {
+      ASSERT_EQ(wheel.next_deadline(), Clock::time_point::max());
+    }
+  }
+}
+
+// Sleeping until next_deadline() and advancing, as the daemon does, fires
+// every timer on its own tick rather than on a later wakeup
+TEST(TimerWheelTest, FollowingNextDeadlineFiresEveryTimerOnTime) {
+  std::mt19937 random(kSeed);
+  std::uniform_int_distribution<Clock::duration::rep> offset(
+      0, Clock::duration(kFarthest).count());
+  const Clock::time_point start(1h);
+  TimerWheel wheel(start);
+  std::map<TimerId, Clock::time_point> due;
+  for (TimerId id = 0; id < kIds; ++id) {
+    const Clock::time_point deadline = start + Clock::duration(offset(random));
+    wheel.schedule(id, deadline);
+    due[id] = start + ceil<TimerWheel::duration>(deadline - start);
+  }
+
+  std::vector<TimerId> expired;
+  std::size_t fired = 0;
+  for (Clock::time_point now = wheel.next_deadline();
+       now != Clock::time_point::max(); now = wheel.next_deadline()) {
+    expired.clear();
+    wheel.advance(now, expired);
+    for (const TimerId id : expired) {
+      EXPECT_EQ(due[id], now) << "timer " << id;
+    }
+    fired += expired.size();
+  }
+  EXPECT_EQ(fired, kIds);
+}
+
+TEST(TimerWheelTest, RescheduleReplacesTheEarlierDeadline) {
+  const Clock::time_point start(1h);
+  TimerWheel wheel(start);
+  wheel.schedule(7, start + 10ms);
+  wheel.schedule(7, start + 2s);
+  std::vector<TimerId> expired;
+  wheel.advance(start + 1s, expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(start + 2s, expired);
+  EXPECT_EQ(expired, std::vector<TimerId>{7});
+  EXPECT_FALSE(wheel.scheduled(7));
+}
@@ -0,0 +1,54 @@
+#include "tty_input.h"
+
+#include <gtest/gtest.h>
+#include <ncurses.h>
+#include <unistd.h>
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace {
+// Keys decoded from bytes written to a pipe, read until the writer's end of
+// input; ERR marks a sequence that names no key
+std::vector<int> decode(std::string_view bytes) {
+  std::array<int, 2> fds{};
+  EXPECT_EQ(pipe(fds.data()), 0);
+  EXPECT_EQ(write(fds[1], bytes.data(), bytes.size()),
+            static_cast<ssize_t>(bytes.size()));
+  close(fds[1]);
+  std::vector<int> keys;
+  {
+    TtyInput input(fds[0]);
+    for (int key = input.read_key(true); key != KEY_EXIT;
+         key = input.read_key(true)) {
+      keys.push_back(key);
+    }
+  }
+  close(fds[0]);
+  return keys;
+}
+}  // namespace
+
+TEST(TtyInputTest, PlainKeysAndSequences) {
+  EXPECT_EQ(decode("s\r\x7f\x1b[A\x1b[B\x1bOH\x1b[4~\x1b[6~"),
+            (std::vector<int>{'s', '\n', KEY_BACKSPACE, KEY_UP, KEY_DOWN,
+                              KEY_HOME, KEY_END, KEY_NPAGE}));
+}
+
+// Modifier parameters after ';' used to stop the parse, leaving "5A" or
+// "2~" to be read as typed keys by the menu filter
+TEST(TtyInputTest, ModifiedKeysAreConsumedWhole) {
+  EXPECT_EQ(decode("\x1b[1;5Ax\x1b[5;2~y\x1b[1;3;5Dz"),
+            (std::vector<int>{KEY_UP, 'x', KEY_PPAGE, 'y', KEY_LEFT, 'z'}));
+}
+
+TEST(TtyInputTest, UnknownSequencesLeaveNothingBehind) {
+  // Shift-F1, F5 and a private-mode report
+  EXPECT_EQ(decode("\x1b[1;2Pa\x1b[15~b\x1b[?1;2cc"),
+            (std::vector<int>{ERR, 'a', ERR, 'b', ERR, 'c'}));
+}
+
+TEST(TtyInputTest, SequenceCutShortByEndOfInput) {
+  EXPECT_EQ(decode("q\x1b[1;5"), (std::vector<int>{'q', ERR}));
+}
@@ -0,0 +1,57 @@
+#include "utf8.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+namespace {
+std::u32string decode(std::string_view text) {
+  std::u32string out;
+  while (!text.empty()) {
+    out += utf8_pop(text);
+  }
+  return out;
+}
+}  // namespace
+
+TEST(Utf8Test, DecodesEveryLength) {
+  EXPECT_EQ(decode("aé█\U0001F345"), U"aé█\U0001F345");
+}
+
+TEST(Utf8Test, RoundTripsThroughAppend) {
+  std::string out;
+  for (const char32_t code_point : {U'a', U'é', U'▉', U'\U0010FFFF'}) {
+    utf8_append(out, code_point);
+  }
+  EXPECT_EQ(decode(out), U"aé▉\U0010FFFF");
+}
+
+TEST(Utf8Test, InvalidLeadBytesDecodeAsReplacement) {
+  for (const char lead : {'\xF8', '\xFB', '\xFF', '\xF5', '\xC0', '\xC1'}) {
+    const std::string text = std::string(1, lead) + "\x80\x80\x80" + "a";
+    EXPECT_EQ(decode(text), U"\uFFFD\uFFFD\uFFFD\uFFFDa")
+        << "lead " << static_cast<int>(static_cast<unsigned char>(lead));
+  }
+}
+
+TEST(Utf8Test, StrayContinuationAndTruncationDecodeAsReplacement) {
+  EXPECT_EQ(decode("\x80x"), U"\uFFFDx");
+  EXPECT_EQ(decode("\xE2\x96"), U"\uFFFD\uFFFD");
+  EXPECT_EQ(decode("\xE2x"), U"\uFFFDx");
+}
+
+TEST(Utf8Test, OverlongSurrogateAndOutOfRangeAreRejected) {
+  // Overlong "/", a UTF-16 surrogate, and U+110000
+  EXPECT_EQ(decode("\xE0\x80\xAF"), U"\uFFFD\uFFFD\uFFFD");
+  EXPECT_EQ(decode("\xED\xA0\x80"), U"\uFFFD\uFFFD\uFFFD");
+  EXPECT_EQ(decode("\xF4\x90\x80\x80"), U"\uFFFD\uFFFD\uFFFD\uFFFD");
+}
+
+TEST(Utf8Test, LengthAgreesWithDecoding) {
+  for (const std::string_view text :
+       {"plain", "█▏ ok", "\x80\x80", "\xF8\x88\x80\x80\x80",
+        "\xC0\xAF", "a\xE2\x96", "\xED\xA0\x80"}) {
+    EXPECT_EQ(utf8_length(text), decode(text).size()) << text;
+  }
+}